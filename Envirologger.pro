@@ -17,17 +17,46 @@ SOURCES += $$PWD/kissfft/kiss_fft.c
 # If you have the internal guts header, keep it in the folder; no need to list it in HEADERS
 # HEADERS should list project headers only (optional to include kissfft headers)
 HEADERS += \
+    asynclogger.h \
+    commandscheduler.h \
+    eventcache.h \
     enlargeplot.h \
+    eventstreamparser.h \
+    livecapturewriter.h \
+    lockfreequeue.h \
+    lodseries.h \
     mainwindow.h \
+    packetdecoder.h \
+    paddingscanner.h \
+    protocoltable.h \
     qcustomplot.h \
-    serialporthandler.h
+    rawconsole.h \
+    sampleexport.h \
+    serialporthandler.h \
+    stripchart.h \
+    signalprocessing.h \
+    tracelog.h
 
 SOURCES += \
+    asynclogger.cpp \
+    commandscheduler.cpp \
+    eventcache.cpp \
     enlargeplot.cpp \
+    eventstreamparser.cpp \
+    livecapturewriter.cpp \
+    lodseries.cpp \
     main.cpp \
     mainwindow.cpp \
+    packetdecoder.cpp \
+    paddingscanner.cpp \
+    protocoltable.cpp \
     qcustomplot.cpp \
-    serialporthandler.cpp
+    rawconsole.cpp \
+    sampleexport.cpp \
+    serialporthandler.cpp \
+    stripchart.cpp \
+    signalprocessing.cpp \
+    tracelog.cpp
 
 FORMS += \
     enlargeplot.ui \
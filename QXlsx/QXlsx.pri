@@ -5,6 +5,9 @@
 QT += core
 QT += gui-private
 
+# xlsxzipwriter deflates through zlib (<QtZlib/zlib.h>), link it when Qt uses the system one
+qtConfig(system-zlib): LIBS += -lz
+
 # TODO: Define your C++ version. c++14, c++17, etc.
 CONFIG += c++11
 
@@ -36,6 +36,15 @@ public:
 
     bool write(const CellReference &cell, const QVariant &value, const Format &format = Format());
     bool write(int row, int col, const QVariant &value, const Format &format = Format());
+    bool writeColumn(int firstRow,
+                     int col,
+                     const double *values,
+                     int count,
+                     const Format &format = Format());
+    bool writeColumn(int firstRow,
+                     int col,
+                     const QVector<double> &values,
+                     const Format &format = Format());
 
     QVariant read(const CellReference &cell) const;
     QVariant read(int row, int col) const;
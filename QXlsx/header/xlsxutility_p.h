@@ -35,6 +35,13 @@ QString unescapeSheetName(const QString &sheetName);
 
 bool isSpaceReserveNeeded(const QString &string);
 
+// Locale independent number text for <v> elements. buffer must hold at least
+// NumberBufferSize bytes, no terminating '\0' is written, the length is returned.
+enum { NumberBufferSize = 32 };
+int integerToChars(qint64 value, char *buffer);
+int doubleToChars(double value, char *buffer);
+QString doubleToString(double value);
+
 QString convertSharedFormula(const QString &rootFormula,
                              const CellReference &rootCell,
                              const CellReference &cell);
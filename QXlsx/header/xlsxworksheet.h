@@ -18,6 +18,7 @@
 #include <QStringList>
 #include <QUrl>
 #include <QVariant>
+#include <QVector>
 
 class WorksheetTest;
 
@@ -79,6 +80,15 @@ public:
                       double value,
                       const Format &format = Format());
     bool writeNumeric(int row, int column, double value, const Format &format = Format());
+    bool writeNumericColumn(int firstRow,
+                            int column,
+                            const double *values,
+                            int count,
+                            const Format &format = Format());
+    bool writeNumericColumn(int firstRow,
+                            int column,
+                            const QVector<double> &values,
+                            const Format &format = Format());
 
     bool writeFormula(const CellReference &row_column,
                       const CellFormula &formula,
@@ -10,6 +10,7 @@
 #include "xlsxdatavalidation.h"
 #include "xlsxworksheet.h"
 
+#include <QBitArray>
 #include <QHash>
 #include <QImage>
 #include <QObject>
@@ -17,6 +18,8 @@
 #include <QString>
 #include <QVector>
 
+#include <algorithm>
+
 class QXmlStreamWriter;
 class QXmlStreamReader;
 
@@ -132,54 +135,109 @@ struct XlsxColumnInfo {
     bool collapsed;
 };
 
+// Contiguous run of plain numeric cells in one column, sharing one format.
+// 8 bytes + 1 bit per cell instead of a hash node, shared_ptr<Cell>, Format and QVariant.
+struct DenseColumn {
+    int firstRow = 1;
+    Format format;
+    QVector<double> values;
+    QBitArray present; // false: never written, or replaced by a sparse cell
+
+    int lastRow() const { return firstRow + values.size() - 1; }
+    bool contains(int row) const
+    {
+        return row >= firstRow && row <= lastRow() && present.testBit(row - firstRow);
+    }
+};
+
 class CellTable
 {
 public:
+    // Rows that may be left empty inside a dense run before falling back to sparse cells
+    static const int DENSE_MAX_GAP = 64;
+
     static QList<int> sorteIntList(QList<int> &&keys)
     {
         std::sort(keys.begin(), keys.end());
         return keys;
     }
 
-    inline QList<int> sortedRows() const
-    {
-        QList<int> keys = cells.keys();
-        std::sort(keys.begin(), keys.end());
-        return keys;
-    }
+    // Rows holding sparse or dense cells
+    QList<int> sortedRows() const;
 
     void setValue(int row, int column, const std::shared_ptr<Cell> &cell)
     {
+        removeDense(row, column);
         cells[row].insert(column, cell);
-        firstRow    = qMin(firstRow, row);
-        firstColumn = qMin(firstColumn, column);
-        lastRow     = qMin(lastRow, row);
-        lastColumn  = qMin(lastColumn, column);
+        updateBounds(row, column);
     }
 
-    std::shared_ptr<Cell> cellAt(int row, int column) const
-    {
-        return cells.value(row).value(column);
-    }
+    // Stores a plain number (no formula) densely when it continues the column's run
+    // with the same format. Returns false if the caller has to create a sparse Cell.
+    bool setNumeric(int row, int column, double value, const Format &format);
+
+    // Bulk version of setNumeric(), the whole block either goes to the dense run or
+    // nothing is stored and false is returned. A run shorter than the block that it
+    // can't continue (e.g. a header number above the data) is moved to sparse cells
+    // and the block starts a new run.
+    bool setNumericRun(int firstRow, int column, const double *values, int count,
+                       const Format &format);
+
+    // A dense cell comes back as a temporary Cell built from the run, the table is left
+    // unchanged (safe for readers and the save path on other threads)
+    std::shared_ptr<Cell> cellAt(int row, int column) const;
+
+    // Same as cellAt(), but a dense cell is moved to the sparse table first so that
+    // changes to the returned Cell stick. Only for writers.
+    std::shared_ptr<Cell> materializeCell(int row, int column);
+
+    // Same lookup without materializing dense cells
+    Format formatAt(int row, int column) const;
 
     bool contains(int row, int column) const
     {
         auto it = cells.find(row);
-        if (it != cells.end()) {
-            return it->contains(column);
-        }
-        return false;
+        if (it != cells.end() && it->contains(column))
+            return true;
+        return containsDense(row, column);
+    }
+
+    bool containsDense(int row, int column) const
+    {
+        auto it = denseColumns.constFind(column);
+        return it != denseColumns.constEnd() && it->contains(row);
+    }
+
+    const DenseColumn *denseColumn(int column) const
+    {
+        auto it = denseColumns.constFind(column);
+        return it != denseColumns.constEnd() ? &it.value() : nullptr;
     }
 
-    bool isEmpty() const { return cells.isEmpty(); }
+    bool isEmpty() const { return cells.isEmpty() && denseCount == 0; }
 
     // It's faster with a single QHash, but in Qt5 it's capacity limits
     // how much cells we can hold
     QHash<int, QHash<int, std::shared_ptr<Cell>>> cells;
+    QHash<int, DenseColumn> denseColumns;
+    int denseCount = 0;
+
+    Worksheet *sheet = nullptr; // parent of materialized dense cells
     int firstRow    = -1;
     int firstColumn = -1;
     int lastRow     = -1;
     int lastColumn  = -1;
+
+private:
+    void removeDense(int row, int column);
+    void moveDenseToSparse(int column, DenseColumn &run);
+    void updateBounds(int row, int column)
+    {
+        firstRow    = firstRow == -1 ? row : qMin(firstRow, row);
+        firstColumn = firstColumn == -1 ? column : qMin(firstColumn, column);
+        lastRow     = qMax(lastRow, row);
+        lastColumn  = qMax(lastColumn, column);
+    }
 };
 
 class WorksheetPrivate : public AbstractSheetPrivate
@@ -203,6 +261,8 @@ public:
                          int row,
                          int col,
                          std::shared_ptr<Cell> cell) const;
+    void saveXmlCellStyle(QXmlStreamWriter &writer, int row, int col, const Format &format) const;
+    int cellStyleIndex(int row, int col, const Format &format) const;
     void saveXmlMergeCells(QXmlStreamWriter &writer) const;
     void saveXmlHyperlinks(QXmlStreamWriter &writer) const;
     void saveXmlDrawings(QXmlStreamWriter &writer) const;
@@ -5,13 +5,23 @@
 
 #include "xlsxglobal.h"
 
+#include <QByteArray>
 #include <QIODevice>
+#include <QList>
 #include <QString>
 
-class QZipWriter;
+#include <functional>
 
 QT_BEGIN_NAMESPACE_XLSX
 
+/*
+  Minimal zip archive writer (deflate / store, zip64 end records for archives
+  larger than 4 GiB).
+
+  Entries added with a writer callback are deflated while the callback writes,
+  so a large part (e.g. a worksheet) never exists as one uncompressed buffer.
+  Such entries use a data descriptor and are limited to 4 GiB each.
+ */
 class ZipWriter
 {
 public:
@@ -21,11 +31,46 @@ public:
 
     void addFile(const QString &filePath, QIODevice *device);
     void addFile(const QString &filePath, const QByteArray &data);
+    void addFile(const QString &filePath, const std::function<void(QIODevice *)> &writer);
+
+    // A part deflated ahead of time, deflateData() is thread safe so parts can be
+    // compressed in parallel and added in order afterwards
+    struct DeflatedData {
+        QByteArray data;
+        quint32 crc          = 0;
+        quint64 uncompressed = 0;
+        bool ok              = false;
+    };
+    static DeflatedData deflateData(const std::function<void(QIODevice *)> &writer);
+    void addDeflatedFile(const QString &filePath, const DeflatedData &deflated);
+
     bool error() const;
     void close();
 
 private:
-    QZipWriter *m_writer;
+    struct Entry {
+        QByteArray name;
+        quint16 flags        = 0;
+        quint16 method       = 0;
+        quint32 crc          = 0;
+        quint64 compressed   = 0;
+        quint64 uncompressed = 0;
+        quint64 offset       = 0;
+    };
+
+    void writeLocalHeader(const Entry &entry);
+    void writeCentralDirectory();
+    bool writeRaw(const char *data, qint64 size);
+    bool writeRaw(const QByteArray &data) { return writeRaw(data.constData(), data.size()); }
+
+    QIODevice *m_device;
+    bool m_ownDevice;
+    bool m_closed;
+    bool m_error;
+    quint64 m_pos; // bytes written so far, the device may not be seekable
+    quint16 m_dosTime;
+    quint16 m_dosDate;
+    QList<Entry> m_entries;
 };
 
 QT_END_NAMESPACE_XLSX
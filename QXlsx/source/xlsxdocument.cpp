@@ -24,8 +24,13 @@
 #include <QDebug>
 #include <QDir>
 #include <QFile>
+#include <QMutex>
 #include <QPointF>
+#include <QRunnable>
 #include <QTemporaryFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
 
 /*
         From Wikipedia: The Open Packaging Conventions (OPC) is a
@@ -65,6 +70,66 @@
 QT_BEGIN_NAMESPACE_XLSX
 
 namespace xlsxDocumentCpp {
+/*
+  Deflated sheets waiting to be written, in sheet order.
+ */
+struct SheetDeflateQueue {
+    QVector<ZipWriter::DeflatedData> results;
+    QVector<bool> finished;
+    QMutex mutex;
+    QWaitCondition finishedChanged;
+
+    explicit SheetDeflateQueue(int count)
+        : results(count)
+        , finished(count, false)
+    {
+    }
+
+    // Blocks until sheet index is deflated, then hands its data over
+    ZipWriter::DeflatedData take(int index)
+    {
+        QMutexLocker locker(&mutex);
+        while (!finished[index])
+            finishedChanged.wait(&mutex);
+        ZipWriter::DeflatedData data = results[index];
+        results[index] = ZipWriter::DeflatedData();
+        return data;
+    }
+};
+
+/*
+  Serialises and deflates one worksheet on a pool thread. Saving only reads
+  the workbook (styles, shared strings), the sheet's own relationships and
+  spans are not shared with other sheets.
+ */
+class SheetDeflateTask : public QRunnable
+{
+public:
+    SheetDeflateTask(AbstractSheet *sheet, SheetDeflateQueue *queue, int index)
+        : m_sheet(sheet)
+        , m_queue(queue)
+        , m_index(index)
+    {
+    }
+
+    void run() override
+    {
+        AbstractSheet *sheet = m_sheet;
+        ZipWriter::DeflatedData data =
+            ZipWriter::deflateData([sheet](QIODevice *out) { sheet->saveToXmlFile(out); });
+
+        QMutexLocker locker(&m_queue->mutex);
+        m_queue->results[m_index] = data;
+        m_queue->finished[m_index] = true;
+        m_queue->finishedChanged.wakeAll();
+    }
+
+private:
+    AbstractSheet *m_sheet;
+    SheetDeflateQueue *m_queue;
+    int m_index;
+};
+
 std::string copyTag(const std::string &sFrom, const std::string &sTo, const std::string &tag)
 {
     const std::string tagToFindStart = "<" + tag;
@@ -339,13 +404,39 @@ bool DocumentPrivate::savePackage(QIODevice *device) const
     if (!worksheets.isEmpty())
         docPropsApp.addHeadingPair(QStringLiteral("Worksheets"), worksheets.size());
 
+    // Several sheets: serialise and deflate them concurrently, the zip entries
+    // are still written in sheet order below. Each sheet is written as soon as it
+    // and the ones before it are done, and only a window of sheets is deflated
+    // ahead, so at most that many compressed sheets are held in memory
+    const bool parallel = worksheets.size() > 1 && QThread::idealThreadCount() > 1;
+    const int threads   = qMin(worksheets.size(), QThread::idealThreadCount());
+    const int window    = threads * 2;
+    xlsxDocumentCpp::SheetDeflateQueue deflateQueue(parallel ? worksheets.size() : 0);
+    QThreadPool pool;
+    if (parallel) {
+        pool.setMaxThreadCount(threads);
+        for (int i = 0; i < qMin(window, worksheets.size()); ++i)
+            pool.start(new xlsxDocumentCpp::SheetDeflateTask(worksheets[i].get(), &deflateQueue, i));
+    }
+
     for (int i = 0; i < worksheets.size(); ++i) {
         std::shared_ptr<AbstractSheet> sheet = worksheets[i];
         contentTypes->addWorksheetName(QStringLiteral("sheet%1").arg(i + 1));
         docPropsApp.addPartTitle(sheet->sheetName());
 
-        zipWriter.addFile(QStringLiteral("xl/worksheets/sheet%1.xml").arg(i + 1),
-                          sheet->saveToXmlData());
+        if (parallel) {
+            zipWriter.addDeflatedFile(QStringLiteral("xl/worksheets/sheet%1.xml").arg(i + 1),
+                                      deflateQueue.take(i)); // released once written
+
+            // One slot free, next sheet of the window
+            if (i + window < worksheets.size())
+                pool.start(new xlsxDocumentCpp::SheetDeflateTask(worksheets[i + window].get(),
+                                                                  &deflateQueue, i + window));
+        } else {
+            // Sheet XML is deflated into the archive while it is generated
+            zipWriter.addFile(QStringLiteral("xl/worksheets/sheet%1.xml").arg(i + 1),
+                              [&sheet](QIODevice *out) { sheet->saveToXmlFile(out); });
+        }
 
         Relationships *rel = sheet->relationships();
         if (!rel->isEmpty())
@@ -417,8 +508,9 @@ bool DocumentPrivate::savePackage(QIODevice *device) const
     // save sharedStrings xml file
     if (!workbook->sharedStrings()->isEmpty()) {
         contentTypes->addSharedString();
+        SharedStrings *sharedStrings = workbook->sharedStrings();
         zipWriter.addFile(QStringLiteral("xl/sharedStrings.xml"),
-                          workbook->sharedStrings()->saveToXmlData());
+                          [sharedStrings](QIODevice *out) { sharedStrings->saveToXmlFile(out); });
     }
 
     // save calc chain [dev16]
@@ -465,7 +557,7 @@ bool DocumentPrivate::savePackage(QIODevice *device) const
     zipWriter.addFile(QStringLiteral("[Content_Types].xml"), contentTypes->saveToXmlData());
 
     zipWriter.close();
-    return true;
+    return !zipWriter.error();
 }
 
 //
@@ -718,6 +810,33 @@ bool Document::write(int row, int col, const QVariant &value, const Format &form
     return false;
 }
 
+/*!
+ * Write \a count numbers from \a values down column \a col, starting at
+ * \a firstRow, all with the \a format.
+ * Returns true on success.
+ *
+ * \sa Worksheet::writeNumericColumn()
+ */
+bool Document::writeColumn(int firstRow,
+                           int col,
+                           const double *values,
+                           int count,
+                           const Format &format)
+{
+    if (Worksheet *sheet = currentWorksheet())
+        return sheet->writeNumericColumn(firstRow, col, values, count, format);
+    return false;
+}
+
+/*!
+ * \overload
+ * Write all \a values down column \a col, starting at \a firstRow.
+ */
+bool Document::writeColumn(int firstRow, int col, const QVector<double> &values, const Format &format)
+{
+    return writeColumn(firstRow, col, values.constData(), values.size(), format);
+}
+
 /*!
         \overload
         Returns the contents of the cell \a cell.
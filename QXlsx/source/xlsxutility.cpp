@@ -4,11 +4,21 @@
 #include "xlsxutility_p.h"
 
 #include <cmath>
+#include <cstring>
 #include <string>
 
+// std::to_chars(double) needs C++17 and a recent standard library (GCC 11, MSVC 2019)
+#if (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)) && \
+    defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
 #include <QColor>
 #include <QDateTime>
 #include <QDebug>
+#include <QLocale>
 #include <QMap>
 #include <QPoint>
 #include <QRegularExpression>
@@ -26,6 +36,58 @@ bool parseXsdBoolean(const QString &value, bool defaultValue)
     return defaultValue;
 }
 
+/*
+ * Decimal text of an integer, written back to front into a small stack buffer.
+ */
+int integerToChars(qint64 value, char *buffer)
+{
+    char digits[24];
+    int n = 0;
+    quint64 magnitude = value < 0 ? 0 - static_cast<quint64>(value) : static_cast<quint64>(value);
+    do {
+        digits[n++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+
+    int length = 0;
+    if (value < 0)
+        buffer[length++] = '-';
+    while (n)
+        buffer[length++] = digits[--n];
+    return length;
+}
+
+/*
+ * Shortest text that reads back as exactly the same double.
+ *
+ * Whole numbers (sample indices, counters, ...) take the integer path. Other
+ * values use std::to_chars (Ryu based) where the standard library has the
+ * floating point overloads, otherwise the double-conversion code bundled
+ * with Qt in its shortest mode.
+ */
+int doubleToChars(double value, char *buffer)
+{
+    if (value == std::floor(value) && std::fabs(value) < 1e15)
+        return integerToChars(static_cast<qint64>(value), buffer);
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const std::to_chars_result result = std::to_chars(buffer, buffer + NumberBufferSize, value);
+    if (result.ec == std::errc())
+        return static_cast<int>(result.ptr - buffer);
+#endif
+
+    const QByteArray text = QByteArray::number(value, 'g', QLocale::FloatingPointShortest);
+    const int length      = qMin(text.size(), static_cast<int>(NumberBufferSize));
+    std::memcpy(buffer, text.constData(), length);
+    return length;
+}
+
+QString doubleToString(double value)
+{
+    char buffer[NumberBufferSize];
+    return QString::fromLatin1(buffer, doubleToChars(value, buffer));
+}
+
 QStringList splitPath(const QString &path)
 {
     int idx = path.lastIndexOf(QLatin1Char('/'));
@@ -62,12 +62,191 @@ WorksheetPrivate::WorksheetPrivate(Worksheet *p, Worksheet::CreateFlag flag)
     , showWhiteSpace(true)
     , urlPattern(QStringLiteral("^([fh]tt?ps?://)|(mailto:)|(file://)"))
 {
+    cellTable.sheet = p;
 }
 
 WorksheetPrivate::~WorksheetPrivate()
 {
 }
 
+QList<int> CellTable::sortedRows() const
+{
+    QList<int> keys = cells.keys();
+    for (auto it = denseColumns.constBegin(); it != denseColumns.constEnd(); ++it) {
+        for (int row = it->firstRow; row <= it->lastRow(); ++row) {
+            if (it->contains(row) && !cells.contains(row))
+                keys.append(row);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+bool CellTable::setNumeric(int row, int column, double value, const Format &format)
+{
+    auto it = denseColumns.find(column);
+    if (it == denseColumns.end())
+        it = denseColumns.insert(column, DenseColumn());
+
+    DenseColumn &run = it.value();
+    if (run.values.isEmpty()) {
+        run.firstRow = row;
+        run.format   = format;
+    } else if (run.format != format || row < run.firstRow ||
+               row > run.lastRow() + 1 + DENSE_MAX_GAP) {
+        return false;
+    }
+
+    const int offset = row - run.firstRow;
+    if (offset >= run.values.size()) {
+        run.values.resize(offset + 1);
+        run.present.resize(offset + 1); // new bits are cleared, gaps stay empty
+    }
+
+    run.values[offset] = value;
+    if (!run.present.testBit(offset)) {
+        run.present.setBit(offset);
+        ++denseCount;
+    }
+
+    // A previous sparse cell at this position is replaced
+    auto rowIt = cells.find(row);
+    if (rowIt != cells.end() && rowIt->remove(column) && rowIt->isEmpty())
+        cells.erase(rowIt);
+
+    updateBounds(row, column);
+    return true;
+}
+
+bool CellTable::setNumericRun(int firstRow, int column, const double *values, int count,
+                              const Format &format)
+{
+    auto it = denseColumns.find(column);
+    if (it == denseColumns.end())
+        it = denseColumns.insert(column, DenseColumn());
+
+    DenseColumn &run = it.value();
+    if (!run.values.isEmpty() &&
+        (run.format != format || firstRow < run.firstRow ||
+         firstRow > run.lastRow() + 1 + DENSE_MAX_GAP)) {
+        // The larger of the two stays dense
+        if (run.values.size() >= count)
+            return false;
+        moveDenseToSparse(column, run);
+    }
+
+    if (run.values.isEmpty()) {
+        run.firstRow = firstRow;
+        run.format   = format;
+    }
+
+    const int offset  = firstRow - run.firstRow;
+    const int oldSize = run.values.size();
+    if (offset + count > oldSize) {
+        run.values.resize(offset + count);
+        run.present.resize(offset + count);
+    }
+
+    std::copy(values, values + count, run.values.begin() + offset);
+
+    // Only cells that were not present before add to the count
+    int added = 0;
+    for (int i = offset; i < offset + count; ++i) {
+        if (i >= oldSize || !run.present.testBit(i))
+            ++added;
+    }
+    run.present.fill(true, offset, offset + count);
+    denseCount += added;
+
+    // Sparse cells inside the block are replaced, walk whichever side is smaller
+    const int lastRowOfBlock = firstRow + count - 1;
+    if (cells.size() < count) {
+        for (auto rowIt = cells.begin(); rowIt != cells.end();) {
+            if (rowIt.key() >= firstRow && rowIt.key() <= lastRowOfBlock &&
+                rowIt->remove(column) && rowIt->isEmpty())
+                rowIt = cells.erase(rowIt);
+            else
+                ++rowIt;
+        }
+    } else {
+        for (int row = firstRow; row <= lastRowOfBlock; ++row) {
+            auto rowIt = cells.find(row);
+            if (rowIt != cells.end() && rowIt->remove(column) && rowIt->isEmpty())
+                cells.erase(rowIt);
+        }
+    }
+
+    updateBounds(firstRow, column);
+    updateBounds(lastRowOfBlock, column);
+    return true;
+}
+
+std::shared_ptr<Cell> CellTable::cellAt(int row, int column) const
+{
+    auto rowIt = cells.constFind(row);
+    if (rowIt != cells.constEnd()) {
+        auto cellIt = rowIt->constFind(column);
+        if (cellIt != rowIt->constEnd())
+            return cellIt.value();
+    }
+
+    const DenseColumn *run = denseColumn(column);
+    if (!run || !run->contains(row))
+        return {};
+
+    return std::make_shared<Cell>(
+        run->values.at(row - run->firstRow), Cell::NumberType, run->format, sheet);
+}
+
+std::shared_ptr<Cell> CellTable::materializeCell(int row, int column)
+{
+    auto cell = cellAt(row, column);
+    if (cell && containsDense(row, column))
+        setValue(row, column, cell);
+    return cell;
+}
+
+Format CellTable::formatAt(int row, int column) const
+{
+    auto rowIt = cells.constFind(row);
+    if (rowIt != cells.constEnd()) {
+        auto cellIt = rowIt->constFind(column);
+        if (cellIt != rowIt->constEnd())
+            return cellIt.value()->format();
+    }
+
+    const DenseColumn *run = denseColumn(column);
+    if (run && run->contains(row))
+        return run->format;
+
+    return {};
+}
+
+void CellTable::moveDenseToSparse(int column, DenseColumn &run)
+{
+    for (int i = 0; i < run.values.size(); ++i) {
+        if (!run.present.testBit(i))
+            continue;
+
+        cells[run.firstRow + i].insert(
+            column, std::make_shared<Cell>(run.values.at(i), Cell::NumberType, run.format, sheet));
+        --denseCount;
+    }
+
+    run = DenseColumn();
+}
+
+void CellTable::removeDense(int row, int column)
+{
+    auto it = denseColumns.find(column);
+    if (it == denseColumns.end() || !it->contains(row))
+        return;
+
+    it->present.clearBit(row - it->firstRow);
+    --denseCount;
+}
+
 /*
   Calculate the "spans" attribute of the <row> tag. This is an
   XLSX optimisation and isn't strictly required. However, it
@@ -207,6 +386,14 @@ Worksheet *Worksheet::copy(const QString &distName, int distId) const
         }
     }
 
+    // Dense numeric runs hold no per cell objects, a plain copy is enough
+    sheet_d->cellTable.denseColumns = d->cellTable.denseColumns;
+    sheet_d->cellTable.denseCount   = d->cellTable.denseCount;
+    sheet_d->cellTable.firstRow     = d->cellTable.firstRow;
+    sheet_d->cellTable.firstColumn  = d->cellTable.firstColumn;
+    sheet_d->cellTable.lastRow      = d->cellTable.lastRow;
+    sheet_d->cellTable.lastColumn   = d->cellTable.lastColumn;
+
     // for (auto it = d->cellTable.cells.begin(); it != d->cellTable.cells.end(); ++it) {
     //     auto cell           = std::make_shared<Cell>(it.value().get());
     //     cell->d_ptr->parent = sheet;
@@ -570,12 +757,7 @@ std::shared_ptr<Cell> Worksheet::cellAt(int row, int col) const
 
 Format WorksheetPrivate::cellFormat(int row, int col) const
 {
-    auto cell = cellTable.cellAt(row, col);
-    if (cell) {
-        return cell->format();
-    }
-
-    return {};
+    return cellTable.formatAt(row, col);
 }
 
 /*!
@@ -720,12 +902,71 @@ bool Worksheet::writeNumeric(int row, int column, double value, const Format &fo
 
     Format fmt = format.isValid() ? format : d->cellFormat(row, column);
     d->workbook->styles()->addXfFormat(fmt);
+
+    // Contiguous numeric columns go to the dense store, everything else stays sparse
+    if (d->cellTable.setNumeric(row, column, value, fmt))
+        return true;
+
     auto cell = std::make_shared<Cell>(value, Cell::NumberType, fmt, this);
     d->cellTable.setValue(row, column, cell);
 
     return true;
 }
 
+/*!
+        Write \a count numbers from \a values to column \a column, starting at
+        \a firstRow, with the \a format.
+
+        The format is resolved and registered once for the whole block and the
+        values are copied into the dense cell store in one go, which is much
+        faster than calling writeNumeric() for each cell.
+        Returns true on success.
+*/
+bool Worksheet::writeNumericColumn(int firstRow,
+                                   int column,
+                                   const double *values,
+                                   int count,
+                                   const Format &format)
+{
+    Q_D(Worksheet);
+    if (count <= 0)
+        return true;
+    if (!values || firstRow < 1 || firstRow + count - 1 > XLSX_ROW_MAX)
+        return false;
+    if (d->checkDimensions(firstRow, column) || d->checkDimensions(firstRow + count - 1, column))
+        return false;
+
+    Format fmt = format.isValid() ? format : d->cellFormat(firstRow, column);
+    d->workbook->styles()->addXfFormat(fmt);
+
+    if (d->cellTable.setNumericRun(firstRow, column, values, count, fmt))
+        return true;
+
+    // Block does not fit the column's dense run, store cell by cell
+    for (int i = 0; i < count; ++i) {
+        const int row = firstRow + i;
+        if (d->cellTable.setNumeric(row, column, values[i], fmt))
+            continue;
+
+        auto cell = std::make_shared<Cell>(values[i], Cell::NumberType, fmt, this);
+        d->cellTable.setValue(row, column, cell);
+    }
+
+    return true;
+}
+
+/*!
+        \overload
+        Write all \a values to column \a column, starting at \a firstRow.
+*/
+bool Worksheet::writeNumericColumn(int firstRow,
+                                   int column,
+                                   const QVector<double> &values,
+                                   const Format &format)
+{
+    return writeNumericColumn(firstRow, column, values.constData(), values.size(), format);
+}
+
 /*!
         \overload
         Write \a formula to the cell \a row_column with the \a format and \a result.
@@ -783,7 +1024,7 @@ bool Worksheet::writeFormula(int row,
         for (int r = range.firstRow(); r <= range.lastRow(); ++r) {
             for (int c = range.firstColumn(); c <= range.lastColumn(); ++c) {
                 if (!(r == row && c == column)) {
-                    if (auto cell = cellAt(r, c)) {
+                    if (auto cell = d->cellTable.materializeCell(r, c)) {
                         cell->d_ptr->formula = sf;
                     } else {
                         auto newCell = std::make_shared<Cell>(result, Cell::NumberType, fmt, this);
@@ -1224,7 +1465,7 @@ bool Worksheet::mergeCells(const CellRange &range, const Format &format)
     for (int row = range.firstRow(); row <= range.lastRow(); ++row) {
         for (int col = range.firstColumn(); col <= range.lastColumn(); ++col) {
             if (row == range.firstRow() && col == range.firstColumn()) {
-                auto cell = cellAt(row, col);
+                auto cell = d->cellTable.materializeCell(row, col);
                 if (cell) {
                     if (format.isValid())
                         cell->d_ptr->format = format;
@@ -1487,10 +1728,47 @@ void WorksheetPrivate::saveXmlSheetData(QXmlStreamWriter &writer) const
 {
     calculateSpans();
 
+    // Dense runs by column offset, looked up once instead of per cell
+    QVector<const DenseColumn *> denseRuns;
+    // Lean path for dense cells: '<c r="' + column letters and the fixed ' s="n"'
+    // of each run, the <c> elements are formatted into rowXml and written to the
+    // device directly instead of going through QXmlStreamWriter per attribute
+    QVector<QByteArray> denseCellPrefix;
+    QVector<QByteArray> denseCellStyle;
+    QIODevice *device = writer.device();
+    if (!cellTable.denseColumns.isEmpty()) {
+        denseRuns.resize(dimension.columnCount());
+        denseCellPrefix.resize(dimension.columnCount());
+        denseCellStyle.resize(dimension.columnCount());
+        for (int col_num = dimension.firstColumn(); col_num <= dimension.lastColumn(); col_num++) {
+            const int index        = col_num - dimension.firstColumn();
+            const DenseColumn *run = cellTable.denseColumn(col_num);
+            denseRuns[index]       = run;
+            if (!run)
+                continue;
+            denseCellPrefix[index] =
+                "<c r=\"" + CellReference(1, col_num).toString().chopped(1).toLatin1();
+            if (!run->format.isEmpty())
+                denseCellStyle[index] =
+                    "\" s=\"" + QByteArray::number(run->format.xfIndex()) + '"';
+        }
+    }
+    QByteArray rowXml;
+    char number[NumberBufferSize];
+
     for (int row_num = dimension.firstRow(); row_num <= dimension.lastRow(); row_num++) {
         auto ctIt = cellTable.cells.constFind(row_num);
         auto riIt = rowsInfo.constFind(row_num);
-        if (ctIt == cellTable.cells.constEnd() && riIt == rowsInfo.constEnd() &&
+
+        bool hasDense = false;
+        for (const DenseColumn *run : qAsConst(denseRuns)) {
+            if (run && run->contains(row_num)) {
+                hasDense = true;
+                break;
+            }
+        }
+
+        if (ctIt == cellTable.cells.constEnd() && riIt == rowsInfo.constEnd() && !hasDense &&
             !comments.contains(row_num)) {
             // Only process rows with cell data / comments / formatting
             continue;
@@ -1535,14 +1813,59 @@ void WorksheetPrivate::saveXmlSheetData(QXmlStreamWriter &writer) const
         }
 
         // Write cell data if row contains filled cells
-        if (ctIt != cellTable.cells.constEnd()) {
+        if (ctIt != cellTable.cells.constEnd() || hasDense) {
+            int rowTextLength = 0;
+            char rowText[NumberBufferSize];
+            if (hasDense) {
+                rowTextLength = integerToChars(row_num, rowText);
+                writer.writeCharacters(QString()); // closes the <row> start tag
+                rowXml.clear();
+            }
+
             for (int col_num = dimension.firstColumn(); col_num <= dimension.lastColumn();
                  col_num++) {
-                auto cellIt = ctIt->find(col_num);
-                if (cellIt != ctIt->end()) {
-                    saveXmlCellData(writer, row_num, col_num, *cellIt);
+                if (ctIt != cellTable.cells.constEnd()) {
+                    auto cellIt = ctIt->find(col_num);
+                    if (cellIt != ctIt->end()) {
+                        if (!rowXml.isEmpty()) {
+                            device->write(rowXml);
+                            rowXml.clear();
+                        }
+                        saveXmlCellData(writer, row_num, col_num, *cellIt);
+                        continue;
+                    }
+                }
+
+                if (hasDense) {
+                    const int index        = col_num - dimension.firstColumn();
+                    const DenseColumn *run = denseRuns.at(index);
+                    if (!run || !run->contains(row_num))
+                        continue;
+
+                    rowXml.append(denseCellPrefix.at(index));
+                    rowXml.append(rowText, rowTextLength);
+                    if (!denseCellStyle.at(index).isEmpty()) {
+                        rowXml.append(denseCellStyle.at(index));
+                    } else {
+                        rowXml.append('"');
+                        const int style = cellStyleIndex(row_num, col_num, run->format);
+                        if (style >= 0) {
+                            rowXml.append(" s=\"", 4);
+                            rowXml.append(number, integerToChars(style, number));
+                            rowXml.append('"');
+                        }
+                    }
+                    rowXml.append(" t=\"n\"><v>", 10);
+                    rowXml.append(number,
+                                  doubleToChars(run->values.at(row_num - run->firstRow), number));
+                    rowXml.append("</v></c>", 8);
                 }
             }
+
+            if (!rowXml.isEmpty()) {
+                device->write(rowXml);
+                rowXml.clear();
+            }
         }
         writer.writeEndElement(); // row
     }
@@ -1560,22 +1883,7 @@ void WorksheetPrivate::saveXmlCellData(QXmlStreamWriter &writer,
 
     writer.writeStartElement(QStringLiteral("c"));
     writer.writeAttribute(QStringLiteral("r"), cell_pos);
-
-    // Style used by the cell, row or col
-    if (!cell->format().isEmpty()) {
-        writer.writeAttribute(QStringLiteral("s"), QString::number(cell->format().xfIndex()));
-    } else {
-        auto rIt = rowsInfo.constFind(row);
-        if (rIt != rowsInfo.constEnd() && !(*rIt)->format.isEmpty()) {
-            writer.writeAttribute(QStringLiteral("s"), QString::number((*rIt)->format.xfIndex()));
-        } else {
-            auto cIt = colsInfoHelper.constFind(col);
-            if (cIt != colsInfoHelper.constEnd() && !(*cIt)->format.isEmpty()) {
-                writer.writeAttribute(QStringLiteral("s"),
-                                      QString::number((*cIt)->format.xfIndex()));
-            }
-        }
-    }
+    saveXmlCellStyle(writer, row, col, cell->format());
 
     if (cell->cellType() == Cell::SharedStringType) // 's'
     {
@@ -1629,7 +1937,7 @@ void WorksheetPrivate::saveXmlCellData(QXmlStreamWriter &writer,
 
         if (cell->value().isValid()) { // note that, invalid value means 'v' is blank
             double value = cell->value().toDouble();
-            writer.writeTextElement(QStringLiteral("v"), QString::number(value, 'g', 15));
+            writer.writeTextElement(QStringLiteral("v"), doubleToString(value));
         }
     } else if (cell->cellType() == Cell::StringType) // 'str'
     {
@@ -1683,13 +1991,42 @@ void WorksheetPrivate::saveXmlCellData(QXmlStreamWriter &writer,
 
         if (cell->value().isValid()) { // note that, invalid value means 'v' is blank
             double value = cell->value().toDouble();
-            writer.writeTextElement(QStringLiteral("v"), QString::number(value, 'g', 15));
+            writer.writeTextElement(QStringLiteral("v"), doubleToString(value));
         }
     }
 
     writer.writeEndElement(); // c
 }
 
+void WorksheetPrivate::saveXmlCellStyle(QXmlStreamWriter &writer,
+                                        int row,
+                                        int col,
+                                        const Format &format) const
+{
+    const int style = cellStyleIndex(row, col, format);
+    if (style >= 0)
+        writer.writeAttribute(QStringLiteral("s"), QString::number(style));
+}
+
+/*
+  xf index of the style used by the cell, row or col, -1 when none applies.
+ */
+int WorksheetPrivate::cellStyleIndex(int row, int col, const Format &format) const
+{
+    if (!format.isEmpty())
+        return format.xfIndex();
+
+    auto rIt = rowsInfo.constFind(row);
+    if (rIt != rowsInfo.constEnd() && !(*rIt)->format.isEmpty())
+        return (*rIt)->format.xfIndex();
+
+    auto cIt = colsInfoHelper.constFind(col);
+    if (cIt != colsInfoHelper.constEnd() && !(*cIt)->format.isEmpty())
+        return (*cIt)->format.xfIndex();
+
+    return -1;
+}
+
 void WorksheetPrivate::saveXmlMergeCells(QXmlStreamWriter &writer) const
 {
     if (merges.isEmpty())
@@ -2865,12 +3202,27 @@ QVector<CellLocation> Worksheet::getFullCells(int *maxRow, int *maxCol)
     }
 
     for (const auto row : d->cellTable.sortedRows()) {
-        auto &columns      = d->cellTable.cells[row];
-        auto columnsSorted = CellTable::sorteIntList(columns.keys());
+        const auto columns = d->cellTable.cells.value(row);
+        QList<int> columnKeys = columns.keys();
+        for (auto it = d->cellTable.denseColumns.constBegin();
+             it != d->cellTable.denseColumns.constEnd();
+             ++it) {
+            if (it->contains(row) && !columns.contains(it.key()))
+                columnKeys.append(it.key());
+        }
+        auto columnsSorted = CellTable::sorteIntList(std::move(columnKeys));
         for (const auto col : columnsSorted) {
             // It's faster to iterate but cellTable is unordered which might not
             // be what callers want?
-            auto cell = std::make_shared<Cell>(columns.value(col).get());
+            std::shared_ptr<Cell> cell;
+            auto cellIt = columns.constFind(col);
+            if (cellIt != columns.constEnd()) {
+                cell = std::make_shared<Cell>(cellIt.value().get());
+            } else {
+                const DenseColumn *run = d->cellTable.denseColumn(col);
+                cell = std::make_shared<Cell>(
+                    run->values.at(row - run->firstRow), Cell::NumberType, run->format, this);
+            }
 
             CellLocation cl;
 
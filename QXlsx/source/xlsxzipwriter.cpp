@@ -2,47 +2,473 @@
 
 #include "xlsxzipwriter_p.h"
 
-#include <private/qzipwriter_p.h>
-
+#include <QDateTime>
 #include <QDebug>
+#include <QFile>
+#include <QtEndian>
+
+#include <QtZlib/zlib.h>
 
 QT_BEGIN_NAMESPACE_XLSX
 
+namespace {
+
+const quint32 LOCAL_HEADER_SIGNATURE    = 0x04034b50;
+const quint32 DATA_DESCRIPTOR_SIGNATURE = 0x08074b50;
+const quint32 CENTRAL_HEADER_SIGNATURE  = 0x02014b50;
+const quint32 ZIP64_END_SIGNATURE       = 0x06064b50;
+const quint32 ZIP64_LOCATOR_SIGNATURE   = 0x07064b50;
+const quint32 END_SIGNATURE             = 0x06054b50;
+
+const quint16 VERSION_DEFAULT = 20;
+const quint16 VERSION_ZIP64   = 45;
+
+const quint16 FLAG_DATA_DESCRIPTOR = 0x0008;
+const quint16 FLAG_UTF8_NAME       = 0x0800;
+
+const quint16 METHOD_STORE   = 0;
+const quint16 METHOD_DEFLATE = 8;
+
+const quint32 MAX_32 = 0xffffffffu;
+const quint16 MAX_16 = 0xffffu;
+
+const int DEFLATE_CHUNK = 256 * 1024;
+
+void put16(QByteArray &out, quint16 value)
+{
+    uchar buf[2];
+    qToLittleEndian<quint16>(value, buf);
+    out.append(reinterpret_cast<const char *>(buf), 2);
+}
+
+void put32(QByteArray &out, quint32 value)
+{
+    uchar buf[4];
+    qToLittleEndian<quint32>(value, buf);
+    out.append(reinterpret_cast<const char *>(buf), 4);
+}
+
+void put64(QByteArray &out, quint64 value)
+{
+    uchar buf[8];
+    qToLittleEndian<quint64>(value, buf);
+    out.append(reinterpret_cast<const char *>(buf), 8);
+}
+
+bool isAscii(const QByteArray &name)
+{
+    for (char c : name) {
+        if (static_cast<uchar>(c) > 0x7f)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+/*
+  Write-only device handed to the writer callbacks of ZipWriter. Input is
+  buffered and raw deflated, compressed bytes go to \a sink (the archive, or a
+  buffer for ZipWriter::deflateData()).
+ */
+class DeflateDevice : public QIODevice
+{
+public:
+    explicit DeflateDevice(const std::function<bool(const char *, int)> &sink)
+        : m_sink(sink)
+    {
+        m_stream = z_stream();
+        m_ok     = deflateInit2(&m_stream,
+                            Z_DEFAULT_COMPRESSION,
+                            Z_DEFLATED,
+                            -MAX_WBITS,
+                            8,
+                            Z_DEFAULT_STRATEGY) == Z_OK;
+        m_crc    = crc32(0, nullptr, 0);
+        m_input.reserve(DEFLATE_CHUNK * 2); // reserved, so resize(0) keeps the buffer
+        m_output.resize(DEFLATE_CHUNK);
+        open(QIODevice::WriteOnly);
+    }
+
+    ~DeflateDevice() override { deflateEnd(&m_stream); }
+
+    bool isValid() const { return m_ok; }
+
+    bool finish()
+    {
+        if (m_ok)
+            m_ok = deflateInput(Z_FINISH);
+        QIODevice::close();
+        return m_ok;
+    }
+
+    quint32 crc() const { return m_crc; }
+    quint64 compressedSize() const { return m_compressed; }
+    quint64 uncompressedSize() const { return m_uncompressed; }
+
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+
+    qint64 writeData(const char *data, qint64 len) override
+    {
+        if (!m_ok)
+            return -1;
+
+        m_input.append(data, static_cast<int>(len));
+        m_uncompressed += static_cast<quint64>(len);
+        if (m_input.size() >= DEFLATE_CHUNK && !(m_ok = deflateInput(Z_NO_FLUSH)))
+            return -1;
+        return len;
+    }
+
+private:
+    bool deflateInput(int flush)
+    {
+        m_crc = crc32(m_crc, reinterpret_cast<const Bytef *>(m_input.constData()),
+                      static_cast<uInt>(m_input.size()));
+
+        m_stream.next_in  = reinterpret_cast<Bytef *>(m_input.data());
+        m_stream.avail_in = static_cast<uInt>(m_input.size());
+
+        for (;;) {
+            m_stream.next_out  = reinterpret_cast<Bytef *>(m_output.data());
+            m_stream.avail_out = static_cast<uInt>(m_output.size());
+
+            const int ret = deflate(&m_stream, flush);
+            if (ret == Z_STREAM_ERROR)
+                return false;
+
+            const int produced = m_output.size() - static_cast<int>(m_stream.avail_out);
+            if (!m_sink(m_output.constData(), produced))
+                return false;
+            m_compressed += static_cast<quint64>(produced);
+
+            if (flush == Z_FINISH ? ret == Z_STREAM_END : m_stream.avail_out != 0)
+                break;
+        }
+
+        m_input.resize(0);
+        return true;
+    }
+
+    std::function<bool(const char *, int)> m_sink;
+    z_stream m_stream;
+    bool m_ok;
+    quint32 m_crc;
+    quint64 m_compressed   = 0;
+    quint64 m_uncompressed = 0;
+    QByteArray m_input;
+    QByteArray m_output;
+};
+
 ZipWriter::ZipWriter(const QString &filePath)
+    : m_device(new QFile(filePath))
+    , m_ownDevice(true)
+    , m_closed(false)
+    , m_error(false)
+    , m_pos(0)
 {
-    m_writer = new QZipWriter(filePath, QIODevice::WriteOnly);
-    m_writer->setCompressionPolicy(QZipWriter::AutoCompress);
+    if (!m_device->open(QIODevice::WriteOnly))
+        m_error = true;
+
+    const QDateTime now = QDateTime::currentDateTime();
+    m_dosTime = static_cast<quint16>((now.time().hour() << 11) | (now.time().minute() << 5) |
+                                     (now.time().second() / 2));
+    m_dosDate = static_cast<quint16>(((now.date().year() - 1980) << 9) |
+                                     (now.date().month() << 5) | now.date().day());
 }
 
 ZipWriter::ZipWriter(QIODevice *device)
+    : m_device(device)
+    , m_ownDevice(false)
+    , m_closed(false)
+    , m_error(false)
+    , m_pos(0)
 {
-    m_writer = new QZipWriter(device);
-    m_writer->setCompressionPolicy(QZipWriter::AutoCompress);
+    if (!m_device->isOpen() && !m_device->open(QIODevice::WriteOnly))
+        m_error = true;
+    else if (!m_device->isWritable())
+        m_error = true;
+
+    const QDateTime now = QDateTime::currentDateTime();
+    m_dosTime = static_cast<quint16>((now.time().hour() << 11) | (now.time().minute() << 5) |
+                                     (now.time().second() / 2));
+    m_dosDate = static_cast<quint16>(((now.date().year() - 1980) << 9) |
+                                     (now.date().month() << 5) | now.date().day());
 }
 
 ZipWriter::~ZipWriter()
 {
-    delete m_writer;
+    close();
+    if (m_ownDevice)
+        delete m_device;
 }
 
 bool ZipWriter::error() const
 {
-    return m_writer->status() != QZipWriter::NoError;
+    return m_error;
 }
 
 void ZipWriter::addFile(const QString &filePath, QIODevice *device)
 {
-    m_writer->addFile(filePath, device);
+    const bool opened = !device->isOpen();
+    if (opened && !device->open(QIODevice::ReadOnly)) {
+        m_error = true;
+        return;
+    }
+
+    addFile(filePath, device->readAll());
+
+    if (opened)
+        device->close();
 }
 
 void ZipWriter::addFile(const QString &filePath, const QByteArray &data)
 {
-    m_writer->addFile(filePath, data);
+    if (m_closed || m_error)
+        return;
+
+    Entry entry;
+    entry.name         = filePath.toUtf8();
+    entry.flags        = isAscii(entry.name) ? 0 : FLAG_UTF8_NAME;
+    entry.crc          = crc32(crc32(0, nullptr, 0),
+                      reinterpret_cast<const Bytef *>(data.constData()),
+                      static_cast<uInt>(data.size()));
+    entry.uncompressed = static_cast<quint64>(data.size());
+    entry.offset       = m_pos;
+
+    // Deflate in one go, store instead when that does not make it smaller
+    QByteArray packed;
+    z_stream stream = z_stream();
+    if (!data.isEmpty() &&
+        deflateInit2(
+            &stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) ==
+            Z_OK) {
+        packed.resize(static_cast<int>(deflateBound(&stream, static_cast<uLong>(data.size()))));
+        stream.next_in   = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+        stream.avail_in  = static_cast<uInt>(data.size());
+        stream.next_out  = reinterpret_cast<Bytef *>(packed.data());
+        stream.avail_out = static_cast<uInt>(packed.size());
+        if (deflate(&stream, Z_FINISH) == Z_STREAM_END)
+            packed.resize(static_cast<int>(stream.total_out));
+        else
+            packed.clear();
+        deflateEnd(&stream);
+    }
+
+    const bool deflated = !packed.isEmpty() && packed.size() < data.size();
+    entry.method        = deflated ? METHOD_DEFLATE : METHOD_STORE;
+    entry.compressed    = static_cast<quint64>(deflated ? packed.size() : data.size());
+
+    writeLocalHeader(entry);
+    writeRaw(deflated ? packed : data);
+    m_entries.append(entry);
+}
+
+/*
+  Streams one entry: \a writer gets a write-only device and everything written
+  to it is deflated into the archive right away.
+ */
+void ZipWriter::addFile(const QString &filePath, const std::function<void(QIODevice *)> &writer)
+{
+    if (m_closed || m_error)
+        return;
+
+    Entry entry;
+    entry.name   = filePath.toUtf8();
+    entry.flags  = FLAG_DATA_DESCRIPTOR | (isAscii(entry.name) ? 0 : FLAG_UTF8_NAME);
+    entry.method = METHOD_DEFLATE;
+    entry.offset = m_pos;
+
+    // crc and sizes follow the data in the data descriptor
+    writeLocalHeader(entry);
+
+    DeflateDevice out([this](const char *data, int size) { return writeRaw(data, size); });
+    if (!out.isValid()) {
+        m_error = true;
+        return;
+    }
+
+    writer(&out);
+    if (!out.finish())
+        m_error = true;
+
+    entry.crc          = out.crc();
+    entry.compressed   = out.compressedSize();
+    entry.uncompressed = out.uncompressedSize();
+
+    if (entry.compressed > MAX_32 || entry.uncompressed > MAX_32) {
+        qWarning() << "[xlsxzipwriter] streamed entry larger than 4 GiB:" << filePath;
+        m_error = true;
+    }
+
+    QByteArray descriptor;
+    put32(descriptor, DATA_DESCRIPTOR_SIGNATURE);
+    put32(descriptor, entry.crc);
+    put32(descriptor, static_cast<quint32>(entry.compressed));
+    put32(descriptor, static_cast<quint32>(entry.uncompressed));
+    writeRaw(descriptor);
+
+    m_entries.append(entry);
+}
+
+ZipWriter::DeflatedData ZipWriter::deflateData(const std::function<void(QIODevice *)> &writer)
+{
+    DeflatedData deflated;
+    DeflateDevice out([&deflated](const char *data, int size) {
+        deflated.data.append(data, size);
+        return true;
+    });
+
+    if (out.isValid()) {
+        writer(&out);
+        deflated.ok = out.finish() && out.uncompressedSize() <= MAX_32 &&
+                      out.compressedSize() <= MAX_32;
+    }
+
+    deflated.crc          = out.crc();
+    deflated.uncompressed = out.uncompressedSize();
+    return deflated;
+}
+
+void ZipWriter::addDeflatedFile(const QString &filePath, const DeflatedData &deflated)
+{
+    if (m_closed || m_error)
+        return;
+
+    if (!deflated.ok) {
+        qWarning() << "[xlsxzipwriter] failed to compress" << filePath;
+        m_error = true;
+        return;
+    }
+
+    Entry entry;
+    entry.name         = filePath.toUtf8();
+    entry.flags        = isAscii(entry.name) ? 0 : FLAG_UTF8_NAME;
+    entry.method       = METHOD_DEFLATE;
+    entry.crc          = deflated.crc;
+    entry.compressed   = static_cast<quint64>(deflated.data.size());
+    entry.uncompressed = deflated.uncompressed;
+    entry.offset       = m_pos;
+
+    writeLocalHeader(entry);
+    writeRaw(deflated.data);
+    m_entries.append(entry);
 }
 
 void ZipWriter::close()
 {
-    m_writer->close();
+    if (m_closed)
+        return;
+
+    m_closed = true;
+    writeCentralDirectory();
+    m_device->close();
+}
+
+void ZipWriter::writeLocalHeader(const Entry &entry)
+{
+    const bool descriptor = entry.flags & FLAG_DATA_DESCRIPTOR;
+
+    QByteArray header;
+    header.reserve(30 + entry.name.size());
+    put32(header, LOCAL_HEADER_SIGNATURE);
+    put16(header, VERSION_DEFAULT);
+    put16(header, entry.flags);
+    put16(header, entry.method);
+    put16(header, m_dosTime);
+    put16(header, m_dosDate);
+    put32(header, descriptor ? 0 : entry.crc);
+    put32(header, descriptor ? 0 : static_cast<quint32>(entry.compressed));
+    put32(header, descriptor ? 0 : static_cast<quint32>(entry.uncompressed));
+    put16(header, static_cast<quint16>(entry.name.size()));
+    put16(header, 0); // extra field length
+    header.append(entry.name);
+    writeRaw(header);
+}
+
+void ZipWriter::writeCentralDirectory()
+{
+    const quint64 directoryOffset = m_pos;
+
+    for (const Entry &entry : qAsConst(m_entries)) {
+        // Local header beyond 4 GiB: offset goes to a zip64 extra field
+        const bool zip64 = entry.offset >= MAX_32;
+
+        QByteArray header;
+        put32(header, CENTRAL_HEADER_SIGNATURE);
+        put16(header, zip64 ? VERSION_ZIP64 : VERSION_DEFAULT); // version made by
+        put16(header, zip64 ? VERSION_ZIP64 : VERSION_DEFAULT); // version needed
+        put16(header, entry.flags);
+        put16(header, entry.method);
+        put16(header, m_dosTime);
+        put16(header, m_dosDate);
+        put32(header, entry.crc);
+        put32(header, static_cast<quint32>(entry.compressed));
+        put32(header, static_cast<quint32>(entry.uncompressed));
+        put16(header, static_cast<quint16>(entry.name.size()));
+        put16(header, zip64 ? 12 : 0); // extra field length
+        put16(header, 0);              // comment length
+        put16(header, 0);              // disk number
+        put16(header, 0);              // internal attributes
+        put32(header, 0);              // external attributes
+        put32(header, zip64 ? MAX_32 : static_cast<quint32>(entry.offset));
+        header.append(entry.name);
+        if (zip64) {
+            put16(header, 0x0001);
+            put16(header, 8);
+            put64(header, entry.offset);
+        }
+        writeRaw(header);
+    }
+
+    const quint64 directorySize = m_pos - directoryOffset;
+    const quint64 entryCount    = static_cast<quint64>(m_entries.size());
+    const bool zip64 = directoryOffset >= MAX_32 || directorySize >= MAX_32 || entryCount >= MAX_16;
+
+    QByteArray end;
+    if (zip64) {
+        const quint64 zip64EndOffset = m_pos;
+
+        put32(end, ZIP64_END_SIGNATURE);
+        put64(end, 44); // size of the remaining record
+        put16(end, VERSION_ZIP64);
+        put16(end, VERSION_ZIP64);
+        put32(end, 0); // this disk
+        put32(end, 0); // disk with the central directory
+        put64(end, entryCount);
+        put64(end, entryCount);
+        put64(end, directorySize);
+        put64(end, directoryOffset);
+
+        put32(end, ZIP64_LOCATOR_SIGNATURE);
+        put32(end, 0);
+        put64(end, zip64EndOffset);
+        put32(end, 1); // total disks
+    }
+
+    put32(end, END_SIGNATURE);
+    put16(end, 0);
+    put16(end, 0);
+    put16(end, static_cast<quint16>(qMin<quint64>(entryCount, MAX_16)));
+    put16(end, static_cast<quint16>(qMin<quint64>(entryCount, MAX_16)));
+    put32(end, static_cast<quint32>(qMin<quint64>(directorySize, MAX_32)));
+    put32(end, static_cast<quint32>(qMin<quint64>(directoryOffset, MAX_32)));
+    put16(end, 0); // comment length
+    writeRaw(end);
+}
+
+bool ZipWriter::writeRaw(const char *data, qint64 size)
+{
+    if (m_error)
+        return false;
+    if (size <= 0)
+        return true;
+
+    if (m_device->write(data, size) != size)
+        m_error = true;
+    m_pos += static_cast<quint64>(size);
+    return !m_error;
 }
 
 QT_END_NAMESPACE_XLSX
@@ -0,0 +1,95 @@
+#include "xlsxdocument.h"
+#include "xlsxformat.h"
+#include "xlsxworksheet.h"
+#include "xlsxworksheet_p.h"
+
+#include <QBuffer>
+#include <QtTest>
+
+using namespace QXlsx;
+
+class WorksheetTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void headerNumberAboveBulkColumn();
+    void longerRunStaysDense();
+
+private:
+    static CellTable &cellTable(Worksheet *sheet) { return sheet->d_func()->cellTable; }
+    static QVector<double> ramp(int count);
+};
+
+QVector<double> WorksheetTest::ramp(int count)
+{
+    QVector<double> values(count);
+    for (int i = 0; i < count; ++i)
+        values[i] = i * 0.5;
+    return values;
+}
+
+// Same layout as the sensor exports: numbers with the default format in B2/B3, then the
+// data column below them with its own format
+void WorksheetTest::headerNumberAboveBulkColumn()
+{
+    Document xlsx;
+    Worksheet *sheet = xlsx.currentWorksheet();
+
+    Format dataFormat;
+    dataFormat.setBorderStyle(Format::BorderThin);
+
+    const QVector<double> values = ramp(1000);
+    QVERIFY(sheet->write(2, 2, QVariant(7)));
+    QVERIFY(sheet->write(3, 2, QVariant(800)));
+    QVERIFY(sheet->writeNumericColumn(6, 2, values, dataFormat));
+
+    CellTable &table = cellTable(sheet);
+    const DenseColumn *run = table.denseColumn(2);
+    QVERIFY(run);
+    QCOMPARE(run->firstRow, 6);
+    QCOMPARE(run->values.size(), values.size());
+    QCOMPARE(table.denseCount, values.size());
+
+    // The header numbers moved to sparse cells, nothing of the block did
+    QVERIFY(table.cells.value(2).contains(2));
+    QVERIFY(table.cells.value(3).contains(2));
+    for (int row = 6; row < 6 + values.size(); ++row)
+        QVERIFY(!table.cells.value(row).contains(2));
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    QVERIFY(xlsx.saveAs(&buffer));
+    buffer.seek(0);
+
+    Document readBack(&buffer);
+    QCOMPARE(readBack.read(2, 2).toDouble(), 7.0);
+    QCOMPARE(readBack.read(3, 2).toDouble(), 800.0);
+    QCOMPARE(readBack.read(6, 2).toDouble(), values.first());
+    QCOMPARE(readBack.read(5 + values.size(), 2).toDouble(), values.last());
+}
+
+// A block smaller than the run it can't continue is stored sparse, the run is kept
+void WorksheetTest::longerRunStaysDense()
+{
+    Document xlsx;
+    Worksheet *sheet = xlsx.currentWorksheet();
+
+    Format otherFormat;
+    otherFormat.setFontBold(true);
+
+    QVERIFY(sheet->writeNumericColumn(1, 2, ramp(100)));
+    QVERIFY(sheet->writeNumericColumn(500, 2, ramp(10), otherFormat));
+
+    CellTable &table = cellTable(sheet);
+    const DenseColumn *run = table.denseColumn(2);
+    QVERIFY(run);
+    QCOMPARE(run->firstRow, 1);
+    QCOMPARE(run->values.size(), 100);
+    QVERIFY(table.cells.value(500).contains(2));
+    QCOMPARE(sheet->read(509, 2).toDouble(), 4.5);
+}
+
+QTEST_MAIN(WorksheetTest)
+
+#include "tst_worksheet.moc"
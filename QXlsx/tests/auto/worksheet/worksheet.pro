@@ -0,0 +1,16 @@
+########################################
+# QXlsx worksheet tests
+#   qmake worksheet.pro && make && ./tst_worksheet
+########################################
+
+QT       += testlib
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_worksheet
+
+include(../../../QXlsx.pri)
+
+SOURCES += tst_worksheet.cpp
+
+DEFINES += QT_DEPRECATED_WARNINGS
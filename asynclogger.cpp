@@ -0,0 +1,360 @@
+#include "asynclogger.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+#include "xlsxzipwriter_p.h"    // QXlsx zip writer, reused for log archives
+
+namespace
+{
+    const int QUEUE_CAPACITY   = 65536;   // lines
+    const int MAX_BATCH_LINES  = 8192;    // lines / trace records per write
+}
+
+AsyncLogger &AsyncLogger::instance()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger()
+    : mQueue(QUEUE_CAPACITY)
+    , mLevel(static_cast<int>(LogLevel::Info))
+    , mFlushIntervalMs(50)
+    , mRunning(false)
+    , mDropped(0)
+    , mTraceEnabled(false)
+    , mTracePayloads(true)
+{
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    close();
+}
+
+bool AsyncLogger::open(const QString &fileName, const QString &traceFileName)
+{
+    close();
+
+    mPolicy = mPendingPolicy;
+    mFileAge.start();
+
+    mFile.setFileName(fileName);
+    if (!mFile.open(QIODevice::Append | QIODevice::Text))
+    {
+        qCritical() << "Failed to open log file." << fileName;
+        return false;
+    }
+
+    // Trace timestamps are relative to this file header, so the trace always starts fresh
+    if (!traceFileName.isEmpty())
+    {
+        mTraceFile.setFileName(traceFileName);
+        if (mTraceFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            mTraceClock.start();
+            mTraceStartEpochMs = QDateTime::currentMSecsSinceEpoch();
+            mTraceFile.write(TraceLog::fileHeader(mTraceStartEpochMs));
+            mTraceEnabled.store(true, std::memory_order_relaxed);
+        }
+        else
+        {
+            qCritical() << "Failed to open trace file." << traceFileName;
+        }
+    }
+
+    mRunning.store(true, std::memory_order_release);
+    start(QThread::LowPriority);
+    return true;
+}
+
+void AsyncLogger::close()
+{
+    if (!mRunning.exchange(false))
+        return;
+
+    mTraceEnabled.store(false, std::memory_order_relaxed);
+
+    {
+        QMutexLocker locker(&mWakeMutex);
+        mWake.wakeAll();
+    }
+
+    // Writer thread drains whatever is still queued before returning
+    wait();
+    mFile.close();
+    mTraceFile.close();
+}
+
+void AsyncLogger::log(LogLevel level, const QString &text)
+{
+    if (!isEnabled(level))
+        return;
+
+    if (!isOpen())
+    {
+        qCritical() << "Log file is not open.";
+        return;
+    }
+
+    LogRecord record;
+    record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    record.level = level;
+    record.text = text;
+
+    if (!mQueue.push(std::move(record)))
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AsyncLogger::trace(TraceEvent type, const QByteArray &payload, bool includePayload)
+{
+    if (!isTraceEnabled())
+        return;
+
+    LogRecord record;
+    record.binary = true;
+    record.traceType = type;
+    record.monotonicNs = static_cast<quint64>(mTraceClock.nsecsElapsed());
+    record.withPayload = includePayload && mTracePayloads.load(std::memory_order_relaxed);
+    record.payload = payload;       // implicitly shared, no copy
+
+    if (!mQueue.push(std::move(record)))
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AsyncLogger::run()
+{
+    while (mRunning.load(std::memory_order_acquire))
+    {
+        // A full batch means a backlog, write the next one straight away; otherwise one write/flush
+        // per interval however the lines trickle in
+        if (drain() == MAX_BATCH_LINES)
+            continue;
+
+        QMutexLocker locker(&mWakeMutex);
+        if (mRunning.load(std::memory_order_acquire))
+            mWake.wait(&mWakeMutex, static_cast<unsigned long>(mFlushIntervalMs.load(std::memory_order_relaxed)));
+    }
+
+    // Final drain after close() was requested
+    while (drain() > 0) {}
+}
+
+int AsyncLogger::drain()
+{
+    mBatch.clear();
+    mTraceBatch.clear();
+
+    int lines = 0;
+    LogRecord record;
+    while (lines < MAX_BATCH_LINES && mQueue.pop(record))
+    {
+        if (record.binary)
+        {
+            TraceLog::appendRecord(mTraceBatch, record.traceType, record.monotonicNs,
+                                   record.payload, record.withPayload);
+        }
+        else
+        {
+            appendTimestamp(mBatch, record.timestampMs);
+            mBatch.append(record.text.toUtf8());
+            mBatch.append('\n');
+        }
+        lines++;
+    }
+
+    quint64 dropped = mDropped.load(std::memory_order_relaxed);
+    if (dropped != mReportedDropped)
+    {
+        appendTimestamp(mBatch, QDateTime::currentMSecsSinceEpoch());
+        mBatch.append("### Log queue full, lines dropped: " + QByteArray::number(dropped - mReportedDropped) + '\n');
+        mReportedDropped = dropped;
+    }
+
+    if (!mBatch.isEmpty())
+    {
+        mFile.write(mBatch);
+        mFile.flush();
+    }
+
+    if (!mTraceBatch.isEmpty() && mTraceFile.isOpen())
+    {
+        mTraceFile.write(mTraceBatch);
+        mTraceFile.flush();
+    }
+
+    rotateIfNeeded();
+
+    return lines;
+}
+
+void AsyncLogger::rotateIfNeeded()
+{
+    const bool expired = mPolicy.rotateIntervalSec > 0
+            && mFileAge.elapsed() >= qint64(mPolicy.rotateIntervalSec) * 1000;
+
+    if (expired || (mPolicy.maxFileBytes > 0 && mFile.size() >= mPolicy.maxFileBytes))
+        rotateTextFile();
+
+    if (mTraceFile.isOpen()
+            && (expired || (mPolicy.maxFileBytes > 0 && mTraceFile.size() >= mPolicy.maxFileBytes)))
+        rotateTraceFile();
+
+    if (expired)
+        mFileAge.restart();
+}
+
+void AsyncLogger::rotateTextFile()
+{
+    const QString fileName = mFile.fileName();
+    mFile.close();
+    archive(fileName);
+
+    if (!mFile.open(QIODevice::Append | QIODevice::Text))
+        qCritical() << "Failed to reopen log file after rotation." << fileName;
+}
+
+void AsyncLogger::rotateTraceFile()
+{
+    const QString fileName = mTraceFile.fileName();
+    mTraceFile.close();
+    archive(fileName);
+
+    // Same start epoch, monotonic timestamps keep counting across rotated files
+    if (mTraceFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        mTraceFile.write(TraceLog::fileHeader(mTraceStartEpochMs));
+    else
+        qCritical() << "Failed to reopen trace file after rotation." << fileName;
+}
+
+bool AsyncLogger::archiveFile(const QString &fileName)
+{
+    // Only while closed, the writer thread owns the policy and archive directory otherwise
+    if (isOpen())
+        return false;
+
+    mPolicy = mPendingPolicy;
+    return archive(fileName);
+}
+
+bool AsyncLogger::archive(const QString &fileName)
+{
+    QFile source(fileName);
+    if (!source.exists() || source.size() == 0)
+    {
+        QFile::remove(fileName);
+        return true;
+    }
+
+    if (!source.open(QIODevice::ReadOnly))
+    {
+        qCritical() << "Failed to read log file for archiving." << fileName;
+        return false;
+    }
+    const QByteArray content = source.readAll();
+    source.close();
+
+    const QString archiveDir = mPolicy.archiveDir;
+    QDir().mkpath(archiveDir);
+
+    // debug_notes.txt -> logs/debug_notes_yyyyMMdd_HHmmss.zip (entry keeps the stamped file name)
+    const QFileInfo info(fileName);
+    const QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+    QString entryName = QString("%1_%2.%3").arg(info.completeBaseName(), stamp, info.suffix());
+    QString archivePath = QString("%1/%2_%3.zip").arg(archiveDir, info.completeBaseName(), stamp);
+    for (int n = 1; QFile::exists(archivePath); ++n)
+    {
+        entryName = QString("%1_%2_%3.%4").arg(info.completeBaseName(), stamp).arg(n).arg(info.suffix());
+        archivePath = QString("%1/%2_%3_%4.zip").arg(archiveDir, info.completeBaseName(), stamp).arg(n);
+    }
+
+    QXlsx::ZipWriter zip(archivePath);
+    zip.addFile(entryName, content);
+    zip.close();
+
+    if (zip.error())
+    {
+        qCritical() << "Failed to write log archive." << archivePath;
+        return false;
+    }
+
+    QFile::remove(fileName);
+    enforceRetention();
+    return true;
+}
+
+void AsyncLogger::enforceRetention()
+{
+    const LogRotationPolicy &policy = mPolicy;
+
+    // Newest first, keep archives until count or byte budget is exceeded
+    QDir dir(policy.archiveDir);
+    const QFileInfoList archives = dir.entryInfoList(QStringList() << "*.zip", QDir::Files, QDir::Time);
+
+    qint64 totalBytes = 0;
+    int kept = 0;
+    for (const QFileInfo &archive : archives)
+    {
+        totalBytes += archive.size();
+        if ((policy.maxArchives > 0 && kept >= policy.maxArchives)
+                || (policy.retentionBytes > 0 && totalBytes > policy.retentionBytes))
+        {
+            QFile::remove(archive.absoluteFilePath());
+        }
+        else
+        {
+            kept++;
+        }
+    }
+}
+
+void AsyncLogger::appendTimestamp(QByteArray &batch, qint64 timestampMs)
+{
+    // Date/time formatting is only done once per second, milliseconds are appended by hand
+    const qint64 second = timestampMs / 1000;
+    if (second != mCachedSecond)
+    {
+        mCachedSecond = second;
+        mCachedSecondText = QDateTime::fromMSecsSinceEpoch(second * 1000)
+                .toString("yyyy-MM-dd HH:mm:ss").toLatin1();
+    }
+
+    const int ms = static_cast<int>(timestampMs % 1000);
+    char msText[5] = { '.', char('0' + ms / 100), char('0' + (ms / 10) % 10), char('0' + ms % 10), '\0' };
+
+    batch.append('[');
+    batch.append(mCachedSecondText);
+    batch.append(msText);
+    batch.append("] ");
+}
+
+LogLevel AsyncLogger::levelFromString(const QString &name, LogLevel fallback)
+{
+    const QString level = name.trimmed().toLower();
+
+    if (level == "trace") return LogLevel::Trace;
+    if (level == "debug") return LogLevel::Debug;
+    if (level == "info") return LogLevel::Info;
+    if (level == "warning") return LogLevel::Warning;
+    if (level == "error") return LogLevel::Error;
+    if (level == "off") return LogLevel::Off;
+
+    return fallback;
+}
+
+QString AsyncLogger::levelName(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::Trace:   return "trace";
+    case LogLevel::Debug:   return "debug";
+    case LogLevel::Info:    return "info";
+    case LogLevel::Warning: return "warning";
+    case LogLevel::Error:   return "error";
+    case LogLevel::Off:     return "off";
+    }
+    return "info";
+}
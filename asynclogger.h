@@ -0,0 +1,136 @@
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <QThread>
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <atomic>
+
+#include "lockfreequeue.h"
+#include "tracelog.h"
+
+// Severity of a debug_notes.txt line, lines below the configured level are dropped by the caller thread
+enum class LogLevel
+{
+    Trace = 0,      // per packet hex dumps
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+// Rotation / retention of debug_notes.txt and debug_trace.bin
+// Rotated files are compressed into archiveDir, oldest archives are removed beyond the budget
+struct LogRotationPolicy
+{
+    qint64 maxFileBytes = 20 * 1024 * 1024;         // rotate when a file grows past this (0 = never)
+    int rotateIntervalSec = 60 * 60;                // rotate after this long (0 = never)
+    qint64 retentionBytes = 200 * 1024 * 1024;      // total size of kept archives
+    int maxArchives = 50;
+    QString archiveDir = "logs";
+};
+
+// Asynchronous logger behind MainWindow::writeToNotes
+// Producers only timestamp and enqueue (lock free, no I/O), a background thread formats
+// the lines and writes/flushes them to disk in batches
+// The same thread also writes the binary packet trace (see tracelog.h) when a trace file is given
+class AsyncLogger : public QThread
+{
+public:
+    static AsyncLogger &instance();
+
+    bool open(const QString &fileName, const QString &traceFileName = QString());
+    void close();
+    bool isOpen() const { return mRunning.load(std::memory_order_acquire); }
+    QString fileName() const { return mFile.fileName(); }
+    QString traceFileName() const { return mTraceFile.fileName(); }
+
+    void setLevel(LogLevel level) { mLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel level() const { return static_cast<LogLevel>(mLevel.load(std::memory_order_relaxed)); }
+    bool isEnabled(LogLevel level) const { return static_cast<int>(level) >= mLevel.load(std::memory_order_relaxed); }
+
+    // Max time a line waits in the queue before it is written
+    void setFlushInterval(int ms) { mFlushIntervalMs.store(qMax(1, ms), std::memory_order_relaxed); }
+
+    // Takes effect on the next open()
+    void setRotationPolicy(const LogRotationPolicy &policy) { mPendingPolicy = policy; }
+
+    // Compresses an existing log file into the archive directory and removes it (logger must be closed)
+    bool archiveFile(const QString &fileName);
+
+    void log(LogLevel level, const QString &text);
+
+    // Binary trace record, the payload is shared (not copied) until the writer thread stores it
+    // includePayload = false records type/length/time only (bytes already traced as DataReceived)
+    bool isTraceEnabled() const { return mTraceEnabled.load(std::memory_order_relaxed); }
+    void setTracePayloads(bool enabled) { mTracePayloads.store(enabled, std::memory_order_relaxed); }
+    void trace(TraceEvent type, const QByteArray &payload, bool includePayload = true);
+
+    quint64 droppedCount() const { return mDropped.load(std::memory_order_relaxed); }
+
+    static LogLevel levelFromString(const QString &name, LogLevel fallback = LogLevel::Info);
+    static QString levelName(LogLevel level);
+
+protected:
+    void run() override;
+
+private:
+    AsyncLogger();
+    ~AsyncLogger();
+
+    struct LogRecord
+    {
+        qint64 timestampMs = 0;
+        LogLevel level = LogLevel::Info;
+        QString text;
+
+        // Binary trace record
+        bool binary = false;
+        bool withPayload = false;
+        TraceEvent traceType = TraceEvent::DataReceived;
+        quint64 monotonicNs = 0;
+        QByteArray payload;
+    };
+
+    // Pops everything queued so far and writes it with a single write/flush, returns lines written
+    int drain();
+    void appendTimestamp(QByteArray &batch, qint64 timestampMs);
+
+    // Writer thread: size / age checks after each batch
+    void rotateIfNeeded();
+    void rotateTextFile();
+    void rotateTraceFile();
+    bool archive(const QString &fileName);
+    void enforceRetention();
+
+    LockFreeQueue<LogRecord> mQueue;
+    std::atomic<int> mLevel;
+    std::atomic<int> mFlushIntervalMs;
+    std::atomic<bool> mRunning;
+    std::atomic<quint64> mDropped;
+    std::atomic<bool> mTraceEnabled;
+    std::atomic<bool> mTracePayloads;
+    quint64 mReportedDropped = 0;
+    QElapsedTimer mTraceClock;
+    qint64 mTraceStartEpochMs = 0;
+    LogRotationPolicy mPendingPolicy;
+    QMutex mWakeMutex;              // only for the flush interval wait, close() wakes it
+    QWaitCondition mWake;
+
+    // Writer thread only
+    LogRotationPolicy mPolicy;
+    QElapsedTimer mFileAge;
+    QFile mFile;
+    QByteArray mBatch;
+    QFile mTraceFile;
+    QByteArray mTraceBatch;
+    qint64 mCachedSecond = -1;
+    QByteArray mCachedSecondText;
+};
+
+#endif // ASYNCLOGGER_H
@@ -0,0 +1,40 @@
+########################################
+# Envirologger headless benchmark
+#   qmake benchmark.pro && make
+#   ./envirologger_bench [--input event.bin] [--output bench.json]
+########################################
+
+QT       += core gui widgets printsupport xml
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = envirologger_bench
+
+# Include QXlsx header and source files
+include(../QXlsx/QXlsx.pri)
+
+INCLUDEPATH += $$PWD/..
+INCLUDEPATH += $$PWD/../kissfft
+
+HEADERS += \
+    ../eventstreamparser.h \
+    ../lodseries.h \
+    ../packetdecoder.h \
+    ../paddingscanner.h \
+    ../qcustomplot.h \
+    ../sampleexport.h \
+    ../signalprocessing.h
+
+SOURCES += \
+    benchmarkmain.cpp \
+    ../eventstreamparser.cpp \
+    ../lodseries.cpp \
+    ../packetdecoder.cpp \
+    ../paddingscanner.cpp \
+    ../qcustomplot.cpp \
+    ../sampleexport.cpp \
+    ../signalprocessing.cpp \
+    ../kissfft/kiss_fft.c
+
+DEFINES += QT_DEPRECATED_WARNINGS
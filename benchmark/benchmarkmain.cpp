@@ -0,0 +1,703 @@
+// Headless throughput benchmark for the Envirologger acquisition pipeline
+//
+// Measures deframing, ADXL / inclinometer decode (serial and parallel), FFT, replot (plain and level of detail)
+// and XLSX export using either a recorded Get Event Data response (--input) or a synthetic one,
+// and prints the results as JSON so runs can be compared by scripts. --corrupt n damages n packets first
+// and reports how parsing recovers from them.
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QSysInfo>
+
+#include "eventstreamparser.h"
+#include "lodseries.h"
+#include "packetdecoder.h"
+#include "sampleexport.h"
+#include "signalprocessing.h"
+#include "qcustomplot.h"
+#include "xlsxdocument.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+
+namespace
+{
+    bool verboseOutput = false;
+
+    // Pipeline code is chatty through qDebug, keep stdout clean for the JSON report
+    void benchMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+    {
+        Q_UNUSED(context);
+        if (verboseOutput || type == QtCriticalMsg || type == QtFatalMsg)
+            fprintf(stderr, "%s\n", msg.toLocal8Bit().constData());
+    }
+
+    double seconds(const QElapsedTimer &timer)
+    {
+        return timer.nsecsElapsed() / 1e9;
+    }
+
+    // Rate for the report, 0 instead of inf when the run was too fast to time
+    double perSecond(double amount, double sec)
+    {
+        return sec > 0 ? amount / sec : 0.0;
+    }
+
+    // ---------------- Synthetic Get Event Data response ----------------
+    QByteArray makeSyntheticEvent(int adxlPackets, int inclPackets, quint32 seed)
+    {
+        QRandomGenerator rng(seed);
+        QByteArray stream;
+        stream.reserve(PacketDecoder::PACKET32_SIZE
+                       + (adxlPackets + inclPackets) * PacketDecoder::PACKET4100_SIZE + 5);
+
+        // Packet32 : AA BB | eventId | adxl freq | incl freq | ... | start time | end time
+        QByteArray packet32(PacketDecoder::PACKET32_SIZE, char(0x00));
+        const quint16 adxlFreq = 20000;
+        const quint16 inclFreq = 1000;
+        packet32[0] = char(0xAA);
+        packet32[1] = char(0xBB);
+        packet32[2] = 0x00;
+        packet32[3] = 0x01;
+        packet32[4] = char(adxlFreq >> 8);
+        packet32[5] = char(adxlFreq & 0xFF);
+        packet32[6] = char(inclFreq >> 8);
+        packet32[7] = char(inclFreq & 0xFF);
+        const char startTime[6] = { 10, 0, 0, 1, 1, 25 };
+        const char endTime[6]   = { 10, 0, 8, 1, 1, 25 };
+        for (int i = 0; i < 6; ++i)
+        {
+            packet32[20 + i] = startTime[i];
+            packet32[26 + i] = endTime[i];
+        }
+        stream.append(packet32);
+
+        // Packet4100 ADXL : 682 samples of 3 x 12 bit big-endian values
+        for (int p = 0; p < adxlPackets; ++p)
+        {
+            stream.append(QByteArray::fromHex("CC DD FF"));
+            for (int s = 0; s < 682 * 3; ++s)
+            {
+                quint16 raw = rng.bounded(4096);
+                stream.append(char(raw >> 8));
+                stream.append(char(raw & 0xFF));
+            }
+            quint16 temp = 0x6000 + rng.bounded(0x100);
+            stream.append(char(temp >> 8));
+            stream.append(char(temp & 0xFF));
+            stream.append(QByteArray::fromHex("FF EE FF"));
+        }
+
+        // Packet4100 Inclinometer : 1023 samples of 2 x 16 bit little-endian values
+        for (int p = 0; p < inclPackets; ++p)
+        {
+            stream.append(QByteArray::fromHex("EE FF FF"));
+            for (int s = 0; s < 1023 * 2; ++s)
+            {
+                quint16 raw = rng.bounded(0x7000);
+                stream.append(char(raw & 0xFF));
+                stream.append(char(raw >> 8));
+            }
+            stream.append(char(0x00));
+            stream.append(char(0x00));
+            stream.append(QByteArray::fromHex("FF CC DD"));
+        }
+
+        stream.append(QByteArray::fromHex("AA BB CC DD FF"));
+        return stream;
+    }
+
+    // ---------------- Noisy line simulation ----------------
+    // Damages count distinct 4100 byte packets the way a bad cable does: a flipped footer byte, dropped or
+    // inserted payload bytes, a flipped header byte. Packets are taken from the end so offsets stay valid
+    QByteArray corruptEvent(const QByteArray &clean, int count, quint32 seed, QJsonArray &faults)
+    {
+        QRandomGenerator rng(seed);
+
+        QList<int> packets;
+        PacketDecoder::EventIndex index;
+        PacketDecoder::indexEventResponse(clean, index);
+        for (const PacketDecoder::PacketRef &ref : index.adxlPackets)
+            packets.append(ref.offset);
+        for (const PacketDecoder::PacketRef &ref : index.inclPackets)
+            packets.append(ref.offset);
+
+        QList<int> chosen;
+        while (chosen.size() < qMin(count, packets.size()))
+        {
+            const int offset = packets.takeAt(rng.bounded(packets.size()));
+            chosen.append(offset);
+        }
+        std::sort(chosen.begin(), chosen.end(), std::greater<int>());
+
+        const char *kinds[] = { "footer", "dropped", "inserted", "header" };
+        QByteArray stream = clean;
+        for (int offset : chosen)
+        {
+            const int kind = rng.bounded(4);
+            const int at = offset + PacketDecoder::HEADER_SIZE + rng.bounded(PacketDecoder::PAYLOAD_SIZE);
+            const int length = 1 + rng.bounded(16);
+            switch (kind)
+            {
+            case 0:
+            {
+                const int i = offset + PacketDecoder::PACKET4100_SIZE - 1 - rng.bounded(PacketDecoder::FOOTER_SIZE);
+                stream[i] = char(stream.at(i) ^ 0x40);
+                break;
+            }
+            case 1:
+                stream.remove(at, length);
+                break;
+            case 2:
+                stream.insert(at, QByteArray(length, char(rng.bounded(256))));
+                break;
+            default:
+            {
+                const int i = offset + rng.bounded(PacketDecoder::HEADER_SIZE);
+                stream[i] = char(stream.at(i) ^ 0x01);
+                break;
+            }
+            }
+
+            QJsonObject fault;
+            fault["offset"] = offset;
+            fault["kind"] = kinds[kind];
+            if (kind == 1 || kind == 2)
+                fault["bytes"] = length;
+            faults.append(fault);
+        }
+        return stream;
+    }
+
+    // ---------------- Deframing (packet offsets over the one response buffer) ----------------
+    QJsonObject benchDeframe(const QByteArray &stream, int iterations, PacketDecoder::EventIndex &index)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for (int it = 0; it < iterations; ++it)
+        {
+            PacketDecoder::EventIndex run;
+            PacketDecoder::indexEventResponse(stream, run);
+            if (it == iterations - 1)
+                index = run;
+        }
+        double sec = seconds(timer);
+
+        QJsonObject result;
+        result["bytes"] = double(stream.size());
+        result["iterations"] = iterations;
+        result["seconds"] = sec;
+        result["mbPerSec"] = perSecond(double(stream.size()) * iterations, sec) / 1e6;
+        result["adxlPackets"] = index.adxlPackets.size();
+        result["inclPackets"] = index.inclPackets.size();
+        result["invalidHeaders"] = index.invalidHeaderCount;
+        result["paddedPackets"] = double(index.padding.paddedPackets);
+        result["ffBytes"] = double(index.padding.ffBytes);
+        return result;
+    }
+
+    // ---------------- Streaming parse (deframe + decode while the bytes arrive) ----------------
+    QJsonObject benchStreamParse(const QByteArray &stream, int iterations, int chunkSize)
+    {
+        EventStreamParser parser;
+        qint64 samples = 0;
+        double firstPacketSec = 0;
+        bool complete = true;
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int it = 0; it < iterations; ++it)
+        {
+            QElapsedTimer firstPacket;
+            firstPacket.start();
+            parser.reset();
+            for (int pos = 0; pos < stream.size(); pos += chunkSize)
+            {
+                // Serial chunks are separate allocations, not views into one response
+                parser.feed(stream.mid(pos, chunkSize));
+                if (it == 0 && firstPacketSec == 0 && parser.event().adxlPackets > 0)
+                    firstPacketSec = seconds(firstPacket);
+            }
+            complete = complete && parser.state() == EventStreamParser::State::Complete;
+            samples += parser.event().xAdxl.size() + parser.event().inclX.size();
+        }
+        double sec = seconds(timer);
+
+        QJsonObject result;
+        result["bytes"] = double(stream.size());
+        result["chunkSize"] = chunkSize;
+        result["iterations"] = iterations;
+        result["seconds"] = sec;
+        result["mbPerSec"] = perSecond(double(stream.size()) * iterations, sec) / 1e6;
+        result["samples"] = double(samples);
+        result["firstAdxlPacketSeconds"] = firstPacketSec;
+        result["complete"] = complete;
+        return result;
+    }
+
+    // ---------------- Integrity (damaged packets skipped, parsing resumed at the next header) ----------------
+    QJsonObject benchIntegrity(const QByteArray &clean, const QByteArray &stream, const QJsonArray &faults,
+                               int chunkSize)
+    {
+        PacketDecoder::EventIndex cleanIndex;
+        PacketDecoder::indexEventResponse(clean, cleanIndex);
+
+        QElapsedTimer timer;
+        timer.start();
+        PacketDecoder::EventIndex index;
+        PacketDecoder::indexEventResponse(stream, index);
+        const double indexSec = seconds(timer);
+
+        // Same bytes as they come off the port
+        timer.restart();
+        EventStreamParser parser;
+        for (int pos = 0; pos < stream.size(); pos += chunkSize)
+            parser.feed(stream.mid(pos, chunkSize));
+        const double streamSec = seconds(timer);
+        const EventStreamParser::Event &event = parser.event();
+
+        bool agree = event.damaged.size() == index.damaged.size();
+        int skippedBytes = 0;
+        QJsonArray damaged;
+        for (int i = 0; i < index.damaged.size(); ++i)
+        {
+            const PacketDecoder::DamagedPacket &d = index.damaged[i];
+            if (agree)
+                agree = event.damaged[i].offset == d.offset && event.damaged[i].skippedBytes == d.skippedBytes;
+            skippedBytes += d.skippedBytes;
+
+            QJsonObject entry;
+            entry["offset"] = d.offset;
+            entry["skippedBytes"] = d.skippedBytes;
+            damaged.append(entry);
+        }
+
+        const int cleanPackets = cleanIndex.adxlPackets.size() + cleanIndex.inclPackets.size();
+        const int decodedPackets = index.adxlPackets.size() + index.inclPackets.size();
+
+        QJsonObject result;
+        result["faults"] = faults;
+        result["damaged"] = damaged;
+        result["packets"] = cleanPackets;
+        result["decodedPackets"] = decodedPackets;
+        result["lostPackets"] = cleanPackets - decodedPackets;
+        result["skippedBytes"] = skippedBytes;
+        result["complete"] = parser.state() == EventStreamParser::State::Complete;
+        result["streamMatchesIndex"] = agree && event.adxlPackets == index.adxlPackets.size()
+                && event.inclPackets == index.inclPackets.size();
+        result["indexSeconds"] = indexSec;
+        result["streamSeconds"] = streamSec;
+        return result;
+    }
+
+    // ---------------- Decoding ----------------
+    QJsonObject benchAdxlDecode(const QByteArray &stream, const PacketDecoder::EventIndex &index, int iterations)
+    {
+        qint64 samples = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (int it = 0; it < iterations; ++it)
+        {
+            QVector<double> x, y, z;
+            for (const PacketDecoder::PacketRef &ref : index.adxlPackets)
+                samples += PacketDecoder::decodeAdxlPayload(stream.constData(), ref, x, y, z);
+        }
+        double sec = seconds(timer);
+
+        QJsonObject result;
+        result["samples"] = double(samples);
+        result["seconds"] = sec;
+        result["samplesPerSec"] = perSecond(samples, sec);
+        return result;
+    }
+
+    QJsonObject benchInclDecode(const QByteArray &stream, const PacketDecoder::EventIndex &index, int iterations)
+    {
+        qint64 samples = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (int it = 0; it < iterations; ++it)
+        {
+            QVector<double> x, y;
+            for (const PacketDecoder::PacketRef &ref : index.inclPackets)
+                samples += PacketDecoder::decodeInclPayload(stream.constData(), ref, x, y);
+        }
+        double sec = seconds(timer);
+
+        QJsonObject result;
+        result["samples"] = double(samples);
+        result["seconds"] = sec;
+        result["samplesPerSec"] = perSecond(samples, sec);
+        return result;
+    }
+
+    // Whole event decoded into preallocated arrays with the given number of threads
+    QJsonObject benchEventDecode(const QByteArray &stream, const PacketDecoder::EventIndex &index, int iterations,
+                                 int threads)
+    {
+        qint64 samples = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (int it = 0; it < iterations; ++it)
+        {
+            PacketDecoder::EventSamples decoded;
+            PacketDecoder::decodeEvent(stream.constData(), index, decoded, threads);
+            samples += decoded.xAdxl.size() + decoded.inclX.size();
+        }
+        double sec = seconds(timer);
+
+        QJsonObject result;
+        result["threads"] = threads;
+        result["samples"] = double(samples);
+        result["seconds"] = sec;
+        result["samplesPerSec"] = perSecond(samples, sec);
+        return result;
+    }
+
+    QJsonObject benchParallelDecode(const QByteArray &stream, const PacketDecoder::EventIndex &index, int iterations)
+    {
+        QJsonObject single = benchEventDecode(stream, index, iterations, 1);
+        QJsonObject parallel = benchEventDecode(stream, index, iterations, QThread::idealThreadCount());
+
+        QJsonObject result;
+        result["singleThread"] = single;
+        result["parallel"] = parallel;
+        result["speedup"] = parallel["seconds"].toDouble() > 0
+                ? single["seconds"].toDouble() / parallel["seconds"].toDouble() : 0.0;
+        return result;
+    }
+
+    // ---------------- FFT (Hanning + kissfft, same path as the plots) ----------------
+    QJsonArray benchFFT(int iterations)
+    {
+        QJsonArray results;
+        QList<int> sizes = { 256, 1024, 4096, 16384, 65536, 682 * 147 };
+
+        for (int n : sizes)
+        {
+            QVector<double> signal(n);
+            for (int i = 0; i < n; ++i)
+                signal[i] = std::sin(2.0 * M_PI * 50.0 * i / 20000.0);
+
+            QElapsedTimer timer;
+            timer.start();
+            for (int it = 0; it < iterations; ++it)
+            {
+                QVector<double> processed = signal;
+                QVector<double> magnitude, freqAxis;
+                SignalProcessing::applyHanning(processed);
+                SignalProcessing::performFFT(processed, magnitude, freqAxis, 20000.0);
+            }
+            double sec = seconds(timer);
+
+            QJsonObject result;
+            result["size"] = n;
+            result["iterations"] = iterations;
+            result["msPerFft"] = sec * 1000.0 / iterations;
+            results.append(result);
+        }
+
+        // X/Y/Z spectra of one event, one after the other and concurrently (event plot path)
+        QVector<QVector<double>> axes(3, QVector<double>(682 * 147));
+        for (int a = 0; a < axes.size(); ++a)
+            for (int i = 0; i < axes[a].size(); ++i)
+                axes[a][i] = std::sin(2.0 * M_PI * 50.0 * (a + 1) * i / 20000.0);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int it = 0; it < iterations; ++it)
+        {
+            for (const QVector<double> &signal : axes)
+                SignalProcessing::computeSpectra({ signal }, 20000.0);
+        }
+        double serialSec = seconds(timer);
+
+        timer.restart();
+        for (int it = 0; it < iterations; ++it)
+            SignalProcessing::computeSpectra(axes, 20000.0);
+        double concurrentSec = seconds(timer);
+
+        QJsonObject spectra;
+        spectra["size"] = axes[0].size();
+        spectra["signals"] = axes.size();
+        spectra["msSerial"] = serialSec * 1000.0 / iterations;
+        spectra["msConcurrent"] = concurrentSec * 1000.0 / iterations;
+        results.append(spectra);
+        return results;
+    }
+
+    // ---------------- Replot ----------------
+    QJsonArray benchReplot(int iterations)
+    {
+        QJsonArray results;
+        QList<int> pointCounts = { 1000, 10000, 100000, 1000000 };
+
+        QCustomPlot plot;
+        plot.resize(1600, 400);
+        plot.addGraph();
+        plot.show();
+
+        for (int n : pointCounts)
+        {
+            QVector<double> keys(n), values(n);
+            for (int i = 0; i < n; ++i)
+            {
+                keys[i] = i;
+                values[i] = std::sin(i * 0.01) + QRandomGenerator::global()->generateDouble() * 0.1;
+            }
+
+            QElapsedTimer timer;
+            timer.start();
+            plot.graph(0)->setData(keys, values, true);
+            double setDataMs = seconds(timer) * 1000.0;
+
+            plot.rescaleAxes();
+            plot.replot(QCustomPlot::rpImmediateRefresh);   // warm up layout
+
+            timer.restart();
+            for (int it = 0; it < iterations; ++it)
+                plot.replot(QCustomPlot::rpImmediateRefresh);
+            double sec = seconds(timer);
+
+            // Same series through the min/max pyramid, zoomed to a quarter and panned each frame
+            timer.restart();
+            QSharedPointer<const LodSeries> series = QSharedPointer<const LodSeries>::create(keys, values);
+            double lodBuildMs = seconds(timer) * 1000.0;
+
+            LodPlotBinder::bind(plot.graph(0), series);
+            plot.rescaleAxes();
+            plot.xAxis->setRange(0, n / 4.0);
+            plot.replot(QCustomPlot::rpImmediateRefresh);
+
+            timer.restart();
+            for (int it = 0; it < iterations; ++it)
+            {
+                plot.xAxis->moveRange(n / 100.0);
+                plot.replot(QCustomPlot::rpImmediateRefresh);
+            }
+            double lodSec = seconds(timer);
+
+            QJsonObject result;
+            result["points"] = n;
+            result["setDataMs"] = setDataMs;
+            result["msPerReplot"] = sec * 1000.0 / iterations;
+            result["lodBuildMs"] = lodBuildMs;
+            result["lodPointsShown"] = plot.graph(0)->dataCount();
+            result["msPerLodPan"] = lodSec * 1000.0 / iterations;
+            results.append(result);
+
+            // Next size starts from plain setData again
+            delete LodPlotBinder::find(plot.graph(0));
+        }
+        return results;
+    }
+
+    // ---------------- XLSX export ----------------
+    QJsonObject benchExport(int rows)
+    {
+        QVector<double> x(rows), y(rows), z(rows);
+        for (int i = 0; i < rows; ++i)
+        {
+            x[i] = std::sin(i * 0.01);
+            y[i] = std::cos(i * 0.01);
+            z[i] = i * 1e-4;
+        }
+
+        QTemporaryDir dir;
+        QString path = dir.path() + "/bench_export.xlsx";
+
+        QXlsx::Format dataFormat;
+        dataFormat.setBorderStyle(QXlsx::Format::BorderThin);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QXlsx::Document xlsx;
+        for (int i = 0; i < rows; ++i)
+        {
+            xlsx.write(i + 1, 1, i, dataFormat);
+            xlsx.write(i + 1, 2, x[i], dataFormat);
+            xlsx.write(i + 1, 3, y[i], dataFormat);
+            xlsx.write(i + 1, 4, z[i], dataFormat);
+        }
+        double writeSec = seconds(timer);
+
+        // Same sheet through the bulk column API
+        QVector<double> index(rows);
+        for (int i = 0; i < rows; ++i)
+            index[i] = i;
+
+        timer.restart();
+        {
+            QXlsx::Document bulk;
+            bulk.writeColumn(1, 1, index, dataFormat);
+            bulk.writeColumn(1, 2, x, dataFormat);
+            bulk.writeColumn(1, 3, y, dataFormat);
+            bulk.writeColumn(1, 4, z, dataFormat);
+        }
+        double bulkWriteSec = seconds(timer);
+
+        timer.restart();
+        bool ok = xlsx.saveAs(path);
+        double saveSec = seconds(timer);
+
+        // Same columns streamed to CSV / Parquet without a workbook
+        QVector<SampleExport::Column> columns;
+        columns << SampleExport::Column("Samples", index) << SampleExport::Column("X", x)
+                << SampleExport::Column("Y", y) << SampleExport::Column("Z", z);
+
+        timer.restart();
+        bool csvOk = SampleExport::writeCsv(dir.path() + "/bench_export.csv", columns, {});
+        double csvSec = seconds(timer);
+
+        timer.restart();
+        bool parquetOk = SampleExport::writeParquet(dir.path() + "/bench_export.parquet", columns, {});
+        double parquetSec = seconds(timer);
+
+        QJsonObject result;
+        result["rows"] = rows;
+        result["columns"] = 4;
+        result["saved"] = ok;
+        result["fileBytes"] = double(QFileInfo(path).size());
+        result["writeSeconds"] = writeSec;
+        result["bulkWriteSeconds"] = bulkWriteSec;
+        result["saveSeconds"] = saveSec;
+        result["rowsPerSec"] = perSecond(rows, writeSec + saveSec);
+        result["csvSaved"] = csvOk;
+        result["csvSeconds"] = csvSec;
+        result["csvFileBytes"] = double(QFileInfo(dir.path() + "/bench_export.csv").size());
+        result["parquetSaved"] = parquetOk;
+        result["parquetSeconds"] = parquetSec;
+        result["parquetFileBytes"] = double(QFileInfo(dir.path() + "/bench_export.parquet").size());
+        return result;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Offscreen rendering unless the caller asked for a real platform
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("envirologger_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Envirologger acquisition pipeline benchmark");
+    parser.addHelpOption();
+    parser.addOption({ "input", "Recorded Get Event Data response (raw bytes).", "file" });
+    parser.addOption({ "output", "Write the JSON report to file instead of stdout.", "file" });
+    parser.addOption({ "iterations", "Iterations per measurement (default 20).", "n", "20" });
+    parser.addOption({ "adxl-packets", "ADXL packets in the synthetic event (default 147).", "n", "147" });
+    parser.addOption({ "incl-packets", "Inclinometer packets in the synthetic event (default 8).", "n", "8" });
+    parser.addOption({ "export-rows", "Rows written by the XLSX export benchmark (default 100000).", "n", "100000" });
+    parser.addOption({ "chunk-size", "Serial chunk size fed to the streaming parser (default 4096).", "bytes", "4096" });
+    parser.addOption({ "corrupt", "Damage n packets of the event as a noisy line would (integrity stage).", "n" });
+    parser.addOption({ "skip", "Comma separated stages to skip (deframe,decode,stream,fft,replot,export).", "list" });
+    parser.addOption({ "verbose", "Forward pipeline debug output to stderr." });
+    parser.process(app);
+
+    verboseOutput = parser.isSet("verbose");
+    qInstallMessageHandler(benchMessageHandler);
+
+    const int iterations = qMax(1, parser.value("iterations").toInt());
+    const QStringList skip = parser.value("skip").split(',', Qt::SkipEmptyParts);
+
+    // ---------------- Input stream ----------------
+    QByteArray stream;
+    QString source;
+    if (parser.isSet("input"))
+    {
+        QFile file(parser.value("input"));
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            fprintf(stderr, "Unable to open %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+        stream = file.readAll();
+        source = file.fileName();
+    }
+    else
+    {
+        stream = makeSyntheticEvent(parser.value("adxl-packets").toInt(),
+                                    parser.value("incl-packets").toInt(), 0x454C4F47);
+        source = "synthetic";
+    }
+
+    QJsonObject report;
+    QJsonObject meta;
+    meta["source"] = source;
+    meta["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    meta["qtVersion"] = QString(qVersion());
+    meta["cpu"] = QSysInfo::currentCpuArchitecture();
+    meta["os"] = QSysInfo::prettyProductName();
+    meta["idealThreadCount"] = QThread::idealThreadCount();
+    meta["iterations"] = iterations;
+    report["meta"] = meta;
+
+    // Every stage below then runs on the damaged event
+    if (parser.isSet("corrupt"))
+    {
+        QJsonArray faults;
+        const QByteArray clean = stream;
+        stream = corruptEvent(clean, qMax(0, parser.value("corrupt").toInt()), 0x4E4F4953, faults);
+        report["integrity"] = benchIntegrity(clean, stream, faults, qMax(1, parser.value("chunk-size").toInt()));
+    }
+
+    PacketDecoder::EventIndex index;
+    if (!skip.contains("deframe") || !skip.contains("decode"))
+    {
+        QJsonObject deframe = benchDeframe(stream, iterations, index);
+        if (!skip.contains("deframe"))
+            report["deframe"] = deframe;
+    }
+
+    if (!skip.contains("decode"))
+    {
+        report["adxlDecode"] = benchAdxlDecode(stream, index, iterations);
+        report["inclDecode"] = benchInclDecode(stream, index, iterations);
+        report["eventDecode"] = benchParallelDecode(stream, index, iterations);
+    }
+
+    if (!skip.contains("stream"))
+        report["streamParse"] = benchStreamParse(stream, iterations, qMax(1, parser.value("chunk-size").toInt()));
+
+    if (!skip.contains("fft"))
+        report["fft"] = benchFFT(iterations);
+
+    if (!skip.contains("replot"))
+        report["replot"] = benchReplot(qMax(1, iterations / 4));
+
+    if (!skip.contains("export"))
+        report["export"] = benchExport(parser.value("export-rows").toInt());
+
+    QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet("output"))
+    {
+        QFile out(parser.value("output"));
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            fprintf(stderr, "Unable to write %s\n", qPrintable(out.fileName()));
+            return 1;
+        }
+        out.write(json);
+    }
+    else
+    {
+        fwrite(json.constData(), 1, json.size(), stdout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "commandscheduler.h"
+
+#include "serialporthandler.h"
+#include <QDebug>
+
+CommandScheduler::CommandScheduler(serialPortHandler *port, QObject *parent)
+    : QObject(parent), mPort(port)
+{
+    mTimer.setSingleShot(true);
+    connect(&mTimer, &QTimer::timeout, this, &CommandScheduler::onTimeout);
+
+    connect(mPort, &serialPortHandler::responseCompleted, this, &CommandScheduler::onResponseCompleted);
+    connect(mPort, &serialPortHandler::dataReceived, this, &CommandScheduler::onDataReceived);
+}
+
+QFuture<CommandScheduler::Result> CommandScheduler::submit(const Request &request, Callback callback)
+{
+    Entry entry;
+    entry.request = request;
+    entry.callback = callback;
+    entry.future.reportStarted();
+    QFuture<Result> future = entry.future.future();
+
+    if (request.immediate && !request.expectsResponse)
+    {
+        qDebug() << "Command written ahead of the queue" << request.label << "pending:" << mQueue.size();
+        const QElapsedTimer inFlight = mElapsed;     // round trip of the command on the link
+        mElapsed.start();
+        finish(entry, mPort->writeData(request.bytes, false) ? Status::Completed : Status::NotSent);
+        mElapsed = inFlight;
+        return future;
+    }
+
+    mQueue.enqueue(entry);
+    qDebug() << "Command queued msgId" << hex << request.msgId << request.label << "pending:" << mQueue.size();
+
+    if (!mBusy)
+        scheduleNext();
+    return future;
+}
+
+void CommandScheduler::clear()
+{
+    while (!mQueue.isEmpty())
+    {
+        Entry entry = mQueue.dequeue();
+        finish(entry, Status::Cancelled);
+    }
+}
+
+void CommandScheduler::startNext()
+{
+    while (!mBusy && !mQueue.isEmpty())
+    {
+        mCurrent = mQueue.dequeue();
+        const Request &request = mCurrent.request;
+
+        // Parser first, so no byte of the response is read with the previous msgId
+        if (request.expectsResponse)
+            mPort->recvMsgId(request.msgId, !request.keepReceive);
+
+        mElapsed.start();
+        if (!mPort->writeData(request.bytes, !request.keepReceive))
+        {
+            finish(mCurrent, Status::NotSent);
+            continue;
+        }
+
+        if (!request.expectsResponse)
+        {
+            finish(mCurrent, Status::Completed);
+            continue;
+        }
+
+        mBusy = true;
+        if (request.timeoutMs > 0)
+            mTimer.start(request.timeoutMs);
+    }
+}
+
+void CommandScheduler::onResponseCompleted(quint8 msgId, const QByteArray &response)
+{
+    if (!mBusy || msgId != mCurrent.request.msgId)
+        return;
+
+    mTimer.stop();
+    mBusy = false;
+    finish(mCurrent, Status::Completed, response);
+    scheduleNext();
+}
+
+void CommandScheduler::onDataReceived()
+{
+    // The timeout is for silence, a long download keeps it running
+    if (mBusy && mCurrent.request.timeoutMs > 0)
+        mTimer.start(mCurrent.request.timeoutMs);
+}
+
+void CommandScheduler::onTimeout()
+{
+    if (!mBusy)
+        return;
+
+    mBusy = false;
+    qWarning() << "Command timed out msgId" << hex << mCurrent.request.msgId << mCurrent.request.label;
+    const Request request = mCurrent.request;
+    finish(mCurrent, Status::TimedOut);
+    emit commandTimedOut(request.msgId, request.label);
+    scheduleNext();
+}
+
+void CommandScheduler::finish(Entry &entry, Status status, const QByteArray &response)
+{
+    Result result;
+    result.msgId = entry.request.msgId;
+    result.status = status;
+    result.response = response;
+    result.elapsedMs = status == Status::Cancelled ? 0 : mElapsed.elapsed();
+
+    entry.future.reportResult(result);
+    entry.future.reportFinished();
+
+    if (entry.callback)
+        entry.callback(result);
+}
+
+void CommandScheduler::scheduleNext()
+{
+    // From the event loop, never from inside readData / a callback: the next command resets the receive buffer
+    QMetaObject::invokeMethod(this, "startNext", Qt::QueuedConnection);
+}
@@ -0,0 +1,95 @@
+#ifndef COMMANDSCHEDULER_H
+#define COMMANDSCHEDULER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QQueue>
+#include <QTimer>
+#include <functional>
+
+class serialPortHandler;
+
+// Queue of device commands, each with its own expected response (msgId) and timeout
+// The protocol carries no request tags, so the device answers one command at a time: the next command is
+// written as soon as the previous response is complete, without waiting for the GUI. Every command gets a
+// future (and optionally a callback), so sequences like set frequency -> start log -> download can be
+// submitted up front.
+class CommandScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    static const int DEFAULT_TIMEOUT_MS = 2000;     // without any byte of the response
+
+    enum class Status
+    {
+        Completed,
+        TimedOut,
+        NotSent,        // port not open
+        Cancelled       // dropped from the queue by clear()
+    };
+
+    struct Request
+    {
+        quint8 msgId = 0;               // response parser of serialPortHandler (protocoltable.cpp)
+        QByteArray bytes;
+        QString label;                  // for the notes
+        int timeoutMs = DEFAULT_TIMEOUT_MS;
+        bool expectsResponse = true;    // false : written in order and completed straight away
+        bool immediate = false;         // without response only : written at submit, ahead of the queue and
+                                        // of the command on the link (whose response keeps being parsed)
+        bool keepReceive = false;       // the response continues the stream on the link (Live Plot Stop),
+                                        // bytes already received are not dropped
+    };
+
+    struct Result
+    {
+        quint8 msgId = 0;
+        Status status = Status::Completed;
+        QByteArray response;            // empty for Get Event Data (delivered by eventDataReady)
+        qint64 elapsedMs = 0;           // from write to response
+    };
+
+    using Callback = std::function<void(const Result &)>;
+
+    explicit CommandScheduler(serialPortHandler *port, QObject *parent = nullptr);
+
+    QFuture<Result> submit(const Request &request, Callback callback = Callback());
+
+    // Cancels the queued commands, the one on the link keeps waiting for its response
+    void clear();
+
+    bool isBusy() const { return mBusy; }
+    int pendingCount() const { return mQueue.size(); }
+
+signals:
+    void commandTimedOut(quint8 msgId, const QString &label);
+
+private slots:
+    void startNext();
+    void onResponseCompleted(quint8 msgId, const QByteArray &response);
+    void onDataReceived();
+    void onTimeout();
+
+private:
+    struct Entry
+    {
+        Request request;
+        Callback callback;
+        QFutureInterface<Result> future;
+    };
+
+    void finish(Entry &entry, Status status, const QByteArray &response = QByteArray());
+    void scheduleNext();
+
+    serialPortHandler *mPort;
+    QQueue<Entry> mQueue;
+    Entry mCurrent;
+    bool mBusy = false;
+    QTimer mTimer;
+    QElapsedTimer mElapsed;
+};
+
+#endif // COMMANDSCHEDULER_H
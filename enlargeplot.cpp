@@ -1,5 +1,6 @@
 #include "enlargeplot.h"
 #include "ui_enlargeplot.h"
+#include "lodseries.h"
 
 enlargePlot::enlargePlot(QWidget *parent) :
     QDialog(parent),
@@ -129,6 +130,13 @@ void enlargePlot::loadPlot(QCustomPlot *sourcePlot)
         dest->addGraph();
         dest->graph(i)->setPen(sourcePlot->graph(i)->pen());
 
+        // Decimated source: share its pyramid instead of copying the samples
+        if (LodPlotBinder *lod = LodPlotBinder::find(sourcePlot->graph(i)))
+        {
+            LodPlotBinder::bind(dest->graph(i), lod->series());
+            continue;
+        }
+
         QVector<double> xData, yData;
 
         // Properly iterate through QCPDataContainer<QCPGraphData>
@@ -208,6 +216,10 @@ void enlargePlot::on_pushButton_fitToScreen_enlargedPlot_clicked()
 
     if (hasData)
     {
+        for (int i = 0; i < plot->graphCount(); ++i)
+            if (LodPlotBinder *lod = LodPlotBinder::find(plot->graph(i)))
+                lod->showAll();
+
         //  Auto-fit axes to show all data
         plot->rescaleAxes(true);
 
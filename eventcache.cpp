@@ -0,0 +1,154 @@
+#include "eventcache.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStringList>
+
+#include "packetdecoder.h"
+
+namespace
+{
+    const quint32 CACHE_MAGIC   = 0x454C4556;     // "ELEV"
+    const quint16 CACHE_VERSION = 1;
+
+    // Port names like "COM3" or "/dev/ttyUSB0" as a directory name
+    QString deviceDirName(const QString &device)
+    {
+        QString name = device.isEmpty() ? QString("unknown") : device;
+        for (QChar &c : name)
+        {
+            if (!c.isLetterOrNumber() && c != '-' && c != '_')
+                c = '_';
+        }
+        return name;
+    }
+}
+
+EventCache::EventCache(const QString &directory)
+    : mDirectory(directory)
+{
+}
+
+QString EventCache::formatTime(const char *timeBytes)
+{
+    QStringList parts;
+    for (int i = 0; i < 6; ++i)
+        parts.append(QString("%1").arg(static_cast<quint8>(timeBytes[i]), 2, 10, QChar('0')));
+
+    return QString("%1:%2:%3 %4/%5/%6")
+            .arg(parts[0]).arg(parts[1]).arg(parts[2])
+            .arg(parts[3]).arg(parts[4]).arg(parts[5]);
+}
+
+QString EventCache::filePath(const QString &device, quint16 eventId) const
+{
+    return QDir(mDirectory).filePath(deviceDirName(device) + QString("/event_%1.elev").arg(eventId));
+}
+
+bool EventCache::contains(const QString &device, quint16 eventId, const QString &start) const
+{
+    if (!mEnabled)
+        return false;
+
+    Entry entry;
+    if (!readEntry(filePath(device, eventId), entry, false))
+        return false;
+    return !start.isEmpty() && entry.start == start;
+}
+
+bool EventCache::load(const QString &device, quint16 eventId, Entry &entry, const QString &start) const
+{
+    if (!mEnabled)
+        return false;
+
+    if (!readEntry(filePath(device, eventId), entry, true))
+        return false;
+    return !start.isEmpty() && entry.start == start;
+}
+
+bool EventCache::store(Entry entry, QString *error)
+{
+    if (!mEnabled || entry.response.isEmpty())
+        return false;
+
+    // Event id and times straight from the event header (AA BB | id | freqs | ... | start | end)
+    if (entry.response.size() >= PacketDecoder::PACKET32_SIZE && entry.response.startsWith(QByteArray::fromHex("AA BB")))
+    {
+        const char *packet32 = entry.response.constData();
+        entry.eventId = quint16((static_cast<quint8>(packet32[2]) << 8) | static_cast<quint8>(packet32[3]));
+        entry.start = formatTime(packet32 + 20);
+        entry.end = formatTime(packet32 + 26);
+    }
+    entry.savedAt = QDateTime::currentDateTime();
+
+    const QString path = filePath(entry.device, entry.eventId);
+    if (!QDir().mkpath(QFileInfo(path).absolutePath()))
+    {
+        if (error)
+            *error = "Unable to create " + QFileInfo(path).absolutePath();
+        return false;
+    }
+
+    // Written to a temporary file and renamed, an interrupted save never leaves a half written event
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << CACHE_MAGIC << CACHE_VERSION
+        << entry.device << entry.eventId << entry.start << entry.end << entry.savedAt
+        << qCompress(entry.response);
+
+    if (out.status() != QDataStream::Ok || !file.commit())
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+
+    qDebug() << "Event" << entry.eventId << "cached:" << path << QFileInfo(path).size() << "bytes";
+    return true;
+}
+
+bool EventCache::readEntry(const QString &path, Entry &entry, bool withResponse) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION)
+    {
+        qWarning() << "Ignoring event cache file" << path << "magic" << hex << magic << "version" << version;
+        return false;
+    }
+
+    in >> entry.device >> entry.eventId >> entry.start >> entry.end >> entry.savedAt;
+    if (withResponse)
+    {
+        QByteArray compressed;
+        in >> compressed;
+        entry.response = qUncompress(compressed);
+        if (entry.response.isEmpty())
+        {
+            qWarning() << "Corrupt event cache file" << path;
+            return false;
+        }
+    }
+
+    return in.status() == QDataStream::Ok;
+}
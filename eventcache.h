@@ -0,0 +1,53 @@
+#ifndef EVENTCACHE_H
+#define EVENTCACHE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+
+// Local copy of downloaded Get Event Data responses, so an event seen before opens without the serial link
+// One file per event: <dir>/<device>/event_<id>.elev
+//   "ELEV" | version | device | event id | start | end | saved at | qCompress(raw response)
+// The device is the serial port it was read from (the protocol carries no serial number); the start time
+// from the event's Packet32 tells a re-used event id apart after the logs were erased.
+class EventCache
+{
+public:
+    struct Entry
+    {
+        QString device;
+        quint16 eventId = 0;
+        QString start;              // "hh:mm:ss dd/mm/yy" as in the Get Log Events table
+        QString end;
+        QDateTime savedAt;
+        QByteArray response;        // whole "AA BB ... AA BB CC DD FF" response
+    };
+
+    explicit EventCache(const QString &directory = "eventcache");
+
+    void setDirectory(const QString &directory) { mDirectory = directory; }
+    QString directory() const { return mDirectory; }
+
+    void setEnabled(bool enabled) { mEnabled = enabled; }
+    bool isEnabled() const { return mEnabled; }
+
+    // Only a copy with the same start time (as listed by Get Log Events) counts, an empty start never matches
+    bool contains(const QString &device, quint16 eventId, const QString &start) const;
+    bool load(const QString &device, quint16 eventId, Entry &entry, const QString &start) const;
+
+    // Fills event id / start / end from the response's Packet32 when it has one
+    bool store(Entry entry, QString *error = nullptr);
+
+    QString filePath(const QString &device, quint16 eventId) const;
+
+    // Time as shown in the Get Log Events table from the 6 time bytes of a Packet32
+    static QString formatTime(const char *timeBytes);
+
+private:
+    bool readEntry(const QString &path, Entry &entry, bool withResponse) const;
+
+    QString mDirectory;
+    bool mEnabled = true;
+};
+
+#endif // EVENTCACHE_H
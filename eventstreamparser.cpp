@@ -0,0 +1,276 @@
+#include "eventstreamparser.h"
+
+#include <QDebug>
+
+using PacketDecoder::PacketType;
+
+namespace
+{
+    const QByteArray EVENT_HEADER = QByteArray::fromHex("AA BB");
+    const QByteArray EVENT_FOOTER = QByteArray::fromHex("AA BB CC DD FF");
+    const QByteArray EVENT_NACK   = QByteArray::fromHex("53 54 45 FF");
+}
+
+EventStreamParser::EventStreamParser()
+{
+}
+
+void EventStreamParser::reset()
+{
+    mState = State::Receiving;
+    mEvent = Event();
+    mPending.clear();
+    mPendingOffset = 0;
+    mResyncing = false;
+}
+
+EventStreamParser::Event EventStreamParser::takeEvent()
+{
+    Event event = mEvent;
+    reset();
+    return event;
+}
+
+EventStreamParser::State EventStreamParser::feed(const QByteArray &chunk)
+{
+    if (mState != State::Receiving || chunk.isEmpty())
+        return mState;
+
+    const qint64 offset = mEvent.bytes;
+    mEvent.bytes += chunk.size();
+    if (mKeepResponse)
+        mEvent.response.append(chunk);
+
+    if (mResyncing)
+    {
+        mPending.append(chunk);
+        resync();
+    }
+    else
+    {
+        consume(chunk.constData(), chunk.size(), offset);
+    }
+
+    checkEnd();
+    return mState;
+}
+
+void EventStreamParser::consume(const char *data, int size, qint64 offset)
+{
+    int pos = 0;
+
+    // ---- Packet carried over from the previous chunk ----
+    if (!mPending.isEmpty())
+    {
+        if (mPending.size() < PacketDecoder::HEADER_SIZE)
+        {
+            const int take = qMin(PacketDecoder::HEADER_SIZE - mPending.size(), size);
+            mPending.append(data, take);
+            pos += take;
+        }
+
+        if (mPending.size() >= PacketDecoder::HEADER_SIZE)
+        {
+            const PacketType type = PacketDecoder::packetType(mPending.constData());
+
+            // Unknown bytes are only awaited at the very start, where they may be the NACK
+            bool damaged = type == PacketType::Unknown && mPendingOffset > 0;
+            if (!damaged)
+            {
+                const int need = PacketDecoder::packetSize(type);
+                const int take = qMin(need - mPending.size(), size - pos);
+                mPending.append(data + pos, take);
+                pos += take;
+
+                if (mPending.size() == need)
+                {
+                    damaged = !processPacket(mPending.constData(), type);
+                    if (!damaged)
+                        mPending.clear();
+                }
+            }
+
+            if (damaged)
+            {
+                startResync(type, mPendingOffset, mPending.left(PacketDecoder::HEADER_SIZE),
+                            mPending.mid(1) + QByteArray(data + pos, size - pos));
+                return;
+            }
+        }
+    }
+
+    // ---- Whole packets decoded straight out of the chunk ----
+    while (mPending.isEmpty() && size - pos >= PacketDecoder::HEADER_SIZE)
+    {
+        const PacketType type = PacketDecoder::packetType(data + pos);
+        const bool unknown = type == PacketType::Unknown && offset + pos > 0;
+        const int need = PacketDecoder::packetSize(type);
+        if (!unknown && size - pos < need)
+            break;
+
+        if (unknown || !processPacket(data + pos, type))
+        {
+            startResync(type, offset + pos, QByteArray(data + pos, PacketDecoder::HEADER_SIZE),
+                        QByteArray(data + pos + 1, size - pos - 1));
+            return;
+        }
+        pos += need;
+    }
+
+    if (pos < size)
+    {
+        if (mPending.isEmpty())
+            mPendingOffset = offset + pos;
+        mPending.append(data + pos, size - pos);
+    }
+}
+
+void EventStreamParser::startResync(PacketType type, qint64 offset, const QByteArray &header,
+                                    const QByteArray &following)
+{
+    PacketDecoder::DamagedPacket damaged;
+    damaged.type = type;
+    damaged.offset = int(offset);
+    damaged.header = header;
+    mEvent.damaged.append(damaged);
+    mEvent.invalidHeaderCount++;
+
+    // Searched from the byte after the damaged header
+    mResyncing = true;
+    mPending = following;
+    mPendingOffset = offset + 1;
+    resync();
+}
+
+void EventStreamParser::resync()
+{
+    int position = 0;
+    const bool found = PacketDecoder::findResync(mPending.constData(), mPending.size(), 0, position);
+
+    PacketDecoder::DamagedPacket &damaged = mEvent.damaged.last();
+    damaged.skippedBytes = int(mPendingOffset + position - damaged.offset);
+
+    if (!found)
+    {
+        // Only the undecided tail is kept
+        mPending.remove(0, position);
+        mPendingOffset += position;
+        return;
+    }
+
+    qDebug() << "Damaged packet at" << damaged.offset << "skipped" << damaged.skippedBytes << "bytes";
+
+    const QByteArray rest = mPending.mid(position);
+    const qint64 restOffset = mPendingOffset + position;
+    mResyncing = false;
+    mPending.clear();
+    consume(rest.constData(), rest.size(), restOffset);
+}
+
+EventStreamParser::Event EventStreamParser::decodeResponse(const QByteArray &response)
+{
+    PacketDecoder::EventIndex index;
+    PacketDecoder::indexEventResponse(response, index);
+
+    PacketDecoder::EventSamples samples;
+    PacketDecoder::decodeEvent(response.constData(), index, samples);
+
+    Event event;
+    for (int offset : index.packet32Offsets)
+        event.packet32List.append(response.mid(offset, PacketDecoder::PACKET32_SIZE));
+    event.xAdxl = samples.xAdxl;
+    event.yAdxl = samples.yAdxl;
+    event.zAdxl = samples.zAdxl;
+    event.temperature = samples.temperature;
+    event.inclX = samples.inclX;
+    event.inclY = samples.inclY;
+    event.paddingList = index.paddingList;
+    event.damaged = index.damaged;
+    event.padding = index.padding;
+    event.adxlPackets = index.adxlPackets.size();
+    event.inclPackets = index.inclPackets.size();
+    event.invalidHeaderCount = index.invalidHeaderCount;
+    event.bytes = response.size();
+    event.response = response;
+    return event;
+}
+
+void EventStreamParser::checkEnd()
+{
+    // Nothing decoded yet and exactly the NACK received
+    if (mPending.size() == mEvent.bytes && mPending == EVENT_NACK)
+    {
+        mState = State::Nack;
+        return;
+    }
+
+    if (!mPending.endsWith(EVENT_FOOTER))
+        return;
+
+    // Footer left after the last packet (shorter than a Packet32, so it can't be an event header),
+    // or arrived inside a 4100 byte packet (bytes lost on the line) / while searching for a header
+    const int lost = mPending.size() - EVENT_FOOTER.size();
+    if (mResyncing)
+    {
+        PacketDecoder::DamagedPacket &damaged = mEvent.damaged.last();
+        damaged.skippedBytes = int(mPendingOffset + lost - damaged.offset);
+    }
+    else if (lost > 0 && !(mPending.size() < PacketDecoder::PACKET32_SIZE && mPending.startsWith(EVENT_HEADER)))
+    {
+        PacketDecoder::DamagedPacket damaged;
+        damaged.type = PacketDecoder::packetType(mPending.constData());
+        damaged.offset = int(mPendingOffset);
+        damaged.header = mPending.left(PacketDecoder::HEADER_SIZE);
+        damaged.skippedBytes = lost;
+        mEvent.damaged.append(damaged);
+        mEvent.invalidHeaderCount++;
+    }
+
+    mState = State::Complete;
+    mResyncing = false;
+    mPending.clear();
+}
+
+bool EventStreamParser::processPacket(const char *packet, PacketType type)
+{
+    switch (type)
+    {
+    case PacketType::Packet32:
+        mEvent.packet32List.append(QByteArray(packet, PacketDecoder::PACKET32_SIZE));
+        break;
+
+    case PacketType::Adxl:
+    {
+        if (!PacketDecoder::hasValidFooter(type, packet))
+            return false;
+
+        // Decoded in place, the padding only shortens the payload
+        const PacketDecoder::PacketRef ref = PacketDecoder::referencePacket(packet, 0, true, mEvent.adxlPackets,
+                                                                            mEvent.paddingList, &mEvent.padding);
+        PacketDecoder::decodeAdxlPayload(packet, ref, mEvent.xAdxl, mEvent.yAdxl, mEvent.zAdxl);
+        mEvent.temperature.append(PacketDecoder::packetTemperature(packet));
+        mEvent.adxlPackets++;
+        break;
+    }
+
+    case PacketType::Incl:
+    {
+        if (!PacketDecoder::hasValidFooter(type, packet))
+            return false;
+
+        const PacketDecoder::PacketRef ref = PacketDecoder::referencePacket(packet, 0, false, mEvent.inclPackets,
+                                                                            mEvent.paddingList, &mEvent.padding);
+        PacketDecoder::decodeInclPayload(packet, ref, mEvent.inclX, mEvent.inclY);
+        mEvent.inclPackets++;
+        break;
+    }
+
+    case PacketType::Unknown:
+        qDebug() << "Unknown header" << QByteArray::fromRawData(packet, PacketDecoder::HEADER_SIZE).toHex()
+                 << "possible footer"
+                 << QByteArray::fromRawData(packet + PacketDecoder::PACKET4100_SIZE - PacketDecoder::FOOTER_SIZE,
+                                            PacketDecoder::FOOTER_SIZE).toHex();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef EVENTSTREAMPARSER_H
+#define EVENTSTREAMPARSER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include "packetdecoder.h"
+
+// Incremental parser for the Get Event Data (msgId 0x01) response
+// Bytes are fed as they arrive from the port, packets are recognised on their 32 / 4100 byte boundaries
+// and decoded straight away, so only the packet in progress is kept instead of the whole response.
+// The response is complete when the "AA BB CC DD FF" footer is all that is left after the last packet.
+class EventStreamParser
+{
+public:
+    enum class State
+    {
+        Receiving,
+        Complete,
+        Nack            // 53 54 45 FF, unknown event id
+    };
+
+    // Decoded event, same content the batch splitter + decoders produce
+    struct Event
+    {
+        QList<QByteArray> packet32List;
+        QVector<double> xAdxl, yAdxl, zAdxl;            // g
+        QVector<double> temperature;                    // °C, one per ADXL packet
+        QVector<double> inclX, inclY;                   // degrees
+        QList<PacketDecoder::PaddingInfo> paddingList;
+        PaddingScanner::Counters padding;               // FF statistics of the 4100 byte packets
+        int adxlPackets = 0;
+        int inclPackets = 0;
+        QList<PacketDecoder::DamagedPacket> damaged;    // left out, parsing resumed at the next confirmed header
+        int invalidHeaderCount = 0;
+        qint64 bytes = 0;                               // whole response, footer included
+        QByteArray response;                            // raw response, only with setKeepResponse(true)
+    };
+
+    EventStreamParser();
+
+    void reset();
+
+    // Also keep the raw bytes in Event::response (for the event cache)
+    void setKeepResponse(bool keep) { mKeepResponse = keep; }
+
+    // Consumes one received chunk, returns the state after it
+    State feed(const QByteArray &chunk);
+
+    State state() const { return mState; }
+    qint64 bytesReceived() const { return mEvent.bytes; }
+    const Event &event() const { return mEvent; }
+
+    // Hands the decoded event over and gets ready for the next download
+    Event takeEvent();
+
+    // Same event from a complete response already in memory (event cache), packets decoded in parallel
+    static Event decodeResponse(const QByteArray &response);
+
+private:
+    // False when the packet is damaged (footer not matching its header, unknown header)
+    bool processPacket(const char *packet, PacketDecoder::PacketType type);
+    void consume(const char *data, int size, qint64 offset);
+    void startResync(PacketDecoder::PacketType type, qint64 offset, const QByteArray &header,
+                     const QByteArray &following);
+    void resync();
+    void checkEnd();
+
+    State mState = State::Receiving;
+    Event mEvent;
+    QByteArray mPending;        // bytes of the packet still being received (searched for a header while resyncing)
+    qint64 mPendingOffset = 0;  // position of mPending in the response
+    bool mResyncing = false;
+    bool mKeepResponse = false;
+};
+
+#endif // EVENTSTREAMPARSER_H
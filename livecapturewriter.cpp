@@ -0,0 +1,238 @@
+#include "livecapturewriter.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+#include <cstring>
+
+#include "xlsxutility_p.h"      // QXlsx::doubleToChars
+
+namespace
+{
+    const int MAX_LINE = 256;
+
+    bool writeHeader(QFile &file, const SampleExport::Metadata &metadata, const QByteArray &columns)
+    {
+        QByteArray header;
+        for (const auto &entry : metadata)
+            header += "# " + entry.first.toUtf8() + ": " + entry.second.toUtf8() + "\n";
+        header += columns + "\n";
+        return file.write(header) == header.size() && file.flush();
+    }
+
+    // index,v0,v1,... per sample
+    void appendRows(QByteArray &out, qint64 firstIndex, const QVector<double> *columns, int columnCount)
+    {
+        char number[QXlsx::NumberBufferSize];
+        const int rows = columns[0].size();
+        for (int row = 0; row < rows; ++row)
+        {
+            out.append(number, QXlsx::integerToChars(firstIndex + row, number));
+            for (int c = 0; c < columnCount; ++c)
+            {
+                out += ',';
+                if (row < columns[c].size())
+                    out.append(number, QXlsx::doubleToChars(columns[c][row], number));
+            }
+            out += '\n';
+        }
+    }
+}
+
+LiveCaptureWriter::LiveCaptureWriter()
+{
+}
+
+LiveCaptureWriter::~LiveCaptureWriter()
+{
+    close();
+}
+
+bool LiveCaptureWriter::open(const QString &basePath, const SampleExport::Metadata &metadata, QString *error)
+{
+    close();
+
+    mAdxlFile.setFileName(basePath + "_adxl.csv");
+    mInclFile.setFileName(basePath + "_incl.csv");
+
+    if (!mAdxlFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || !mInclFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || !writeHeader(mAdxlFile, metadata, "Samples,ADXL X (g),ADXL Y (g),ADXL Z (g)")
+            || !writeHeader(mInclFile, metadata, "Incl Index,Incl X (deg),Incl Y (deg)"))
+    {
+        const QString text = mAdxlFile.isOpen() ? mInclFile.errorString() : mAdxlFile.errorString();
+        qDebug() << "Live capture: unable to open" << basePath << text;
+        if (error)
+            *error = text;
+        mAdxlFile.close();
+        mInclFile.close();
+        return false;
+    }
+
+    mPending = Chunk();
+    mAdxlCount = 0;
+    mInclCount = 0;
+    mStopping = false;
+    mError = false;
+    mOpen = true;
+    mSinceQueued.start();
+
+    start(QThread::LowPriority);
+    qDebug() << "Live capture: writing" << mAdxlFile.fileName() << "and" << mInclFile.fileName();
+    return true;
+}
+
+void LiveCaptureWriter::close()
+{
+    if (!mOpen)
+        return;
+
+    queuePending();
+    {
+        QMutexLocker locker(&mMutex);
+        mStopping = true;
+        mWake.wakeOne();
+    }
+    wait();
+
+    mAdxlFile.close();
+    mInclFile.close();
+    mBuffer.clear();
+    mBuffer.squeeze();
+    mOpen = false;
+
+    qDebug() << "Live capture: closed," << mAdxlCount << "ADXL samples," << mInclCount << "inclinometer samples";
+}
+
+bool LiveCaptureWriter::hasError() const
+{
+    QMutexLocker locker(&mMutex);
+    return mError;
+}
+
+void LiveCaptureWriter::appendAdxl(const QVector<double> &x, const QVector<double> &y, const QVector<double> &z)
+{
+    if (!mOpen)
+        return;
+
+    mPending.adxl[0] += x;
+    mPending.adxl[1] += y;
+    mPending.adxl[2] += z;
+    mAdxlCount += x.size();
+
+    if (mSinceQueued.elapsed() >= mFlushIntervalMs)
+        queuePending();
+}
+
+void LiveCaptureWriter::appendIncl(const QVector<double> &x, const QVector<double> &y)
+{
+    if (!mOpen)
+        return;
+
+    mPending.incl[0] += x;
+    mPending.incl[1] += y;
+    mInclCount += x.size();
+
+    if (mSinceQueued.elapsed() >= mFlushIntervalMs)
+        queuePending();
+}
+
+void LiveCaptureWriter::queuePending()
+{
+    mSinceQueued.restart();
+    if (mPending.isEmpty())
+        return;
+
+    Chunk next;
+    next.adxlStart = mAdxlCount;
+    next.inclStart = mInclCount;
+
+    QMutexLocker locker(&mMutex);
+    mChunks.enqueue(mPending);
+    mPending = next;
+    mWake.wakeOne();
+}
+
+void LiveCaptureWriter::run()
+{
+    forever
+    {
+        Chunk chunk;
+        {
+            QMutexLocker locker(&mMutex);
+            while (mChunks.isEmpty() && !mStopping)
+                mWake.wait(&mMutex);
+            if (mChunks.isEmpty())
+                return;     // stopping and everything written
+            chunk = mChunks.dequeue();
+        }
+
+        if (!writeChunk(chunk))
+        {
+            QMutexLocker locker(&mMutex);
+            if (!mError)
+                qDebug() << "Live capture: write failed" << mAdxlFile.errorString() << mInclFile.errorString();
+            mError = true;
+        }
+    }
+}
+
+bool LiveCaptureWriter::writeChunk(const Chunk &chunk)
+{
+    bool ok = true;
+
+    // ---- ADXL rows ----
+    if (!chunk.adxl[0].isEmpty())
+    {
+        mBuffer.clear();
+        appendRows(mBuffer, chunk.adxlStart, chunk.adxl, 3);
+        ok = mAdxlFile.write(mBuffer) == mBuffer.size() && mAdxlFile.flush() && ok;
+    }
+
+    // ---- Inclinometer rows ----
+    if (!chunk.incl[0].isEmpty())
+    {
+        mBuffer.clear();
+        appendRows(mBuffer, chunk.inclStart, chunk.incl, 2);
+        ok = mInclFile.write(mBuffer) == mBuffer.size() && mInclFile.flush() && ok;
+    }
+
+    return ok;
+}
+
+bool LiveCaptureWriter::readColumns(const QString &fileName, int columnCount, QVector<QVector<double>> &columns)
+{
+    columns = QVector<QVector<double>>(columnCount);
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    char line[MAX_LINE];
+    bool headerSeen = false;
+    qint64 length;
+    while ((length = file.readLine(line, sizeof(line))) > 0)
+    {
+        if (line[0] == '#')
+            continue;
+        if (!headerSeen)
+        {
+            headerSeen = true;
+            continue;
+        }
+
+        // Skip the index field, then one value per column (locale independent parsing)
+        const char *p = static_cast<const char *>(memchr(line, ',', size_t(length)));
+        const char *end = line + length;
+        for (int c = 0; c < columnCount && p; ++c)
+        {
+            const char *field = p + 1;
+            p = static_cast<const char *>(memchr(field, ',', size_t(end - field)));
+            const char *fieldEnd = p ? p : end;
+            while (fieldEnd > field && (fieldEnd[-1] == '\n' || fieldEnd[-1] == '\r'))
+                fieldEnd--;
+            columns[c].append(QByteArray::fromRawData(field, int(fieldEnd - field)).toDouble());
+        }
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#ifndef LIVECAPTUREWRITER_H
+#define LIVECAPTUREWRITER_H
+
+#include <QThread>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QVector>
+#include <QElapsedTimer>
+
+#include "sampleexport.h"
+
+// Writes live capture samples to disk while acquisition runs
+// ADXL and inclinometer run at different rates, so each goes to its own CSV that is only ever appended:
+//   <base>_adxl.csv   Samples,ADXL X (g),ADXL Y (g),ADXL Z (g)
+//   <base>_incl.csv   Incl Index,Incl X (deg),Incl Y (deg)
+// The GUI thread only moves decoded samples into a pending chunk, a background thread formats,
+// writes and flushes a chunk every flush interval, so memory stays flat and a crash loses at most
+// one interval of data
+class LiveCaptureWriter : public QThread
+{
+public:
+    LiveCaptureWriter();
+    ~LiveCaptureWriter();
+
+    bool open(const QString &basePath, const SampleExport::Metadata &metadata, QString *error = nullptr);
+    void close();       // writes what is pending and waits for the writer thread
+    bool isOpen() const { return mOpen; }
+
+    void setFlushInterval(int ms) { mFlushIntervalMs = qMax(100, ms); }
+
+    void appendAdxl(const QVector<double> &x, const QVector<double> &y, const QVector<double> &z);
+    void appendIncl(const QVector<double> &x, const QVector<double> &y);
+
+    QString adxlFileName() const { return mAdxlFile.fileName(); }
+    QString inclFileName() const { return mInclFile.fileName(); }
+    qint64 adxlSamples() const { return mAdxlCount; }
+    qint64 inclSamples() const { return mInclCount; }
+    bool hasError() const;
+
+    // Reads the data columns of a file written by this class back (used for the XLSX conversion)
+    static bool readColumns(const QString &fileName, int columnCount, QVector<QVector<double>> &columns);
+
+protected:
+    void run() override;
+
+private:
+    struct Chunk
+    {
+        qint64 adxlStart = 0;
+        QVector<double> adxl[3];
+        qint64 inclStart = 0;
+        QVector<double> incl[2];
+
+        bool isEmpty() const { return adxl[0].isEmpty() && incl[0].isEmpty(); }
+    };
+
+    void queuePending();
+    bool writeChunk(const Chunk &chunk);
+
+    // GUI thread
+    bool mOpen = false;
+    int mFlushIntervalMs = 2000;
+    QElapsedTimer mSinceQueued;
+    Chunk mPending;
+    qint64 mAdxlCount = 0;
+    qint64 mInclCount = 0;
+
+    // Shared
+    mutable QMutex mMutex;
+    QWaitCondition mWake;
+    QQueue<Chunk> mChunks;
+    bool mStopping = false;
+    bool mError = false;
+
+    // Writer thread (opened / closed by the GUI thread while it is not running)
+    QFile mAdxlFile;
+    QFile mInclFile;
+    QByteArray mBuffer;
+};
+
+#endif // LIVECAPTUREWRITER_H
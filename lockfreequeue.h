@@ -0,0 +1,118 @@
+#ifndef LOCKFREEQUEUE_H
+#define LOCKFREEQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Bounded multi-producer / multi-consumer queue (Dmitry Vyukov's array based design)
+// push() and pop() never block and never allocate, capacity is rounded up to a power of two
+template <typename T>
+class LockFreeQueue
+{
+public:
+    explicit LockFreeQueue(size_t capacity)
+        : mCells(roundUpPow2(capacity))
+        , mMask(mCells.size() - 1)
+        , mEnqueuePos(0)
+        , mDequeuePos(0)
+    {
+        for (size_t i = 0; i < mCells.size(); ++i)
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    LockFreeQueue(const LockFreeQueue &) = delete;
+    LockFreeQueue &operator=(const LockFreeQueue &) = delete;
+
+    // Returns false when the queue is full
+    bool push(T &&value)
+    {
+        Cell *cell;
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &mCells[pos & mMask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns false when the queue is empty
+    bool pop(T &value)
+    {
+        Cell *cell;
+        size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &mCells[pos & mMask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mDequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->data);
+        cell->data = T();
+        cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return mCells.size(); }
+
+private:
+    struct Cell
+    {
+        Cell() : sequence(0) {}
+        Cell(const Cell &) : sequence(0) {}     // only used while sizing the vector
+
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t roundUpPow2(size_t v)
+    {
+        size_t p = 2;
+        while (p < v)
+            p <<= 1;
+        return p;
+    }
+
+    std::vector<Cell> mCells;
+    const size_t mMask;
+
+    // Producers and consumer on separate cache lines
+    alignas(64) std::atomic<size_t> mEnqueuePos;
+    alignas(64) std::atomic<size_t> mDequeuePos;
+};
+
+#endif // LOCKFREEQUEUE_H
@@ -0,0 +1,216 @@
+#include "lodseries.h"
+
+#include <algorithm>
+
+namespace
+{
+    const int FALLBACK_PIXEL_WIDTH = 1920;  // axis rect not laid out yet
+    const int POINTS_PER_PIXEL     = 2;     // raw samples are served up to this density
+}
+
+LodSeries::LodSeries(const QVector<double> &keys, const QVector<double> &values)
+    : mKeys(keys)
+    , mValues(values)
+{
+    const int count = qMin(mKeys.size(), mValues.size());
+    if (mKeys.size() != count) mKeys.resize(count);
+    if (mValues.size() != count) mValues.resize(count);
+
+    // ---- First level straight from the samples ----
+    if (count <= LOD_FACTOR)
+        return;
+
+    Level first;
+    first.bucketSize = LOD_FACTOR;
+    const int firstBuckets = (count + LOD_FACTOR - 1) / LOD_FACTOR;
+    first.minIndex.resize(firstBuckets);
+    first.maxIndex.resize(firstBuckets);
+
+    for (int b = 0; b < firstBuckets; ++b)
+    {
+        const int start = b * LOD_FACTOR;
+        const int end = qMin(start + LOD_FACTOR, count);
+        int minI = start, maxI = start;
+        for (int i = start + 1; i < end; ++i)
+        {
+            if (mValues[i] < mValues[minI]) minI = i;
+            if (mValues[i] > mValues[maxI]) maxI = i;
+        }
+        first.minIndex[b] = minI;
+        first.maxIndex[b] = maxI;
+    }
+    mLevels.append(first);
+
+    // ---- Each further level merges LOD_FACTOR buckets of the previous one ----
+    while (mLevels.last().minIndex.size() > LOD_FACTOR)
+    {
+        const Level &prev = mLevels.last();
+        const int prevBuckets = prev.minIndex.size();
+
+        Level next;
+        next.bucketSize = prev.bucketSize * LOD_FACTOR;
+        const int buckets = (prevBuckets + LOD_FACTOR - 1) / LOD_FACTOR;
+        next.minIndex.resize(buckets);
+        next.maxIndex.resize(buckets);
+
+        for (int b = 0; b < buckets; ++b)
+        {
+            const int start = b * LOD_FACTOR;
+            const int end = qMin(start + LOD_FACTOR, prevBuckets);
+            int minI = prev.minIndex[start], maxI = prev.maxIndex[start];
+            for (int i = start + 1; i < end; ++i)
+            {
+                if (mValues[prev.minIndex[i]] < mValues[minI]) minI = prev.minIndex[i];
+                if (mValues[prev.maxIndex[i]] > mValues[maxI]) maxI = prev.maxIndex[i];
+            }
+            next.minIndex[b] = minI;
+            next.maxIndex[b] = maxI;
+        }
+        mLevels.append(next);
+    }
+}
+
+QCPRange LodSeries::keyRange() const
+{
+    if (mKeys.isEmpty())
+        return QCPRange(0, 0);
+    return QCPRange(mKeys.first(), mKeys.last());
+}
+
+int LodSeries::query(double lower, double upper, int pixelWidth,
+                     QVector<double> &keysOut, QVector<double> &valuesOut) const
+{
+    keysOut.clear();
+    valuesOut.clear();
+    if (mKeys.isEmpty())
+        return 0;
+
+    // Visible index window, one sample beyond each edge so the line leaves the plot
+    int first = static_cast<int>(std::lower_bound(mKeys.constBegin(), mKeys.constEnd(), lower) - mKeys.constBegin());
+    int last = static_cast<int>(std::upper_bound(mKeys.constBegin(), mKeys.constEnd(), upper) - mKeys.constBegin());
+    first = qMax(0, first - 1);
+    last = qMin(mKeys.size() - 1, last);
+
+    const int visible = last - first + 1;
+    const int targetPoints = qMax(1, pixelWidth) * POINTS_PER_PIXEL;
+
+    // ---- Zoomed in far enough: raw samples ----
+    if (visible <= targetPoints || mLevels.isEmpty())
+    {
+        keysOut = mKeys.mid(first, visible);
+        valuesOut = mValues.mid(first, visible);
+        return 0;
+    }
+
+    // ---- Coarsest level that still gives at least one bucket per pixel ----
+    const int samplesPerPixel = visible / qMax(1, pixelWidth);
+    int level = 0;
+    while (level + 1 < mLevels.size() && mLevels[level + 1].bucketSize <= samplesPerPixel)
+        level++;
+
+    const Level &lod = mLevels[level];
+    const int firstBucket = first / lod.bucketSize;
+    const int lastBucket = last / lod.bucketSize;
+
+    keysOut.reserve((lastBucket - firstBucket + 1) * 2 + 2);
+    valuesOut.reserve(keysOut.capacity());
+
+    // Keep the real edge samples so panning does not jump at bucket boundaries
+    auto append = [&](int index)
+    {
+        if (!keysOut.isEmpty() && mKeys[index] <= keysOut.last())
+            return;
+        keysOut.append(mKeys[index]);
+        valuesOut.append(mValues[index]);
+    };
+
+    append(first);
+    for (int b = firstBucket; b <= lastBucket; ++b)
+    {
+        // Min and max in sample order, so the line is drawn the way the signal went
+        const int a = qMin(lod.minIndex[b], lod.maxIndex[b]);
+        const int c = qMax(lod.minIndex[b], lod.maxIndex[b]);
+        append(a);
+        append(c);
+    }
+    append(last);
+
+    return level + 1;
+}
+
+LodPlotBinder::LodPlotBinder(QCPGraph *graph, QSharedPointer<const LodSeries> series)
+    : QObject(graph)
+    , mGraph(graph)
+    , mSeries(series)
+{
+    connect(graph->keyAxis(), SIGNAL(rangeChanged(QCPRange)), this, SLOT(refresh()));
+}
+
+LodPlotBinder *LodPlotBinder::bind(QCPGraph *graph, QSharedPointer<const LodSeries> series)
+{
+    if (!graph || !graph->keyAxis())
+        return nullptr;
+
+    LodPlotBinder *binder = find(graph);
+    if (binder)
+    {
+        binder->mSeries = series;
+        binder->mLastLevel = -1;
+    }
+    else
+    {
+        binder = new LodPlotBinder(graph, series);
+    }
+
+    // Full range view, so a following rescaleAxes() fits the whole event
+    const QCPRange range = series ? series->keyRange() : QCPRange(0, 0);
+    binder->load(range.lower, range.upper);
+    return binder;
+}
+
+LodPlotBinder *LodPlotBinder::find(QCPGraph *graph)
+{
+    return graph ? graph->findChild<LodPlotBinder *>(QString(), Qt::FindDirectChildrenOnly) : nullptr;
+}
+
+void LodPlotBinder::showAll()
+{
+    if (!mSeries || mSeries->isEmpty())
+        return;
+
+    const QCPRange range = mSeries->keyRange();
+    mGraph->keyAxis()->setRange(range);
+    load(range.lower, range.upper);     // no rangeChanged when the range was already the same
+}
+
+void LodPlotBinder::refresh()
+{
+    const QCPRange range = mGraph->keyAxis()->range();
+    load(range.lower, range.upper);
+}
+
+void LodPlotBinder::load(double lower, double upper)
+{
+    if (!mSeries)
+    {
+        mGraph->data()->clear();
+        return;
+    }
+
+    int pixelWidth = mGraph->keyAxis()->axisRect()->width();
+    if (pixelWidth <= 0)
+        pixelWidth = FALLBACK_PIXEL_WIDTH;
+
+    QVector<double> keys, values;
+    const int level = mSeries->query(lower, upper, pixelWidth, keys, values);
+
+    const double firstKey = keys.isEmpty() ? 0 : keys.first();
+    if (level == mLastLevel && keys.size() == mLastCount && firstKey == mLastFirstKey)
+        return;
+
+    mLastLevel = level;
+    mLastCount = keys.size();
+    mLastFirstKey = firstKey;
+
+    mGraph->setData(keys, values, true);
+}
@@ -0,0 +1,78 @@
+#ifndef LODSERIES_H
+#define LODSERIES_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "qcustomplot.h"
+
+// Level of detail (min/max pyramid) for one long time series
+// Level n keeps, per bucket of LOD_FACTOR^n samples, the index of the minimum and maximum sample,
+// so any zoom level is served with ~2 points per pixel and peaks are never lost
+class LodSeries
+{
+public:
+    static const int LOD_FACTOR = 4;
+
+    // keys must be ascending, both vectors are implicitly shared (not copied)
+    LodSeries(const QVector<double> &keys, const QVector<double> &values);
+
+    int size() const { return mKeys.size(); }
+    bool isEmpty() const { return mKeys.isEmpty(); }
+    QCPRange keyRange() const;
+    const QVector<double> &keys() const { return mKeys; }
+    const QVector<double> &values() const { return mValues; }
+
+    // Points covering [lower, upper] (plus one neighbour each side) for a plot pixelWidth wide
+    // Returns the pyramid level used (0 = raw samples)
+    int query(double lower, double upper, int pixelWidth,
+              QVector<double> &keysOut, QVector<double> &valuesOut) const;
+
+private:
+    struct Level
+    {
+        int bucketSize = 1;
+        QVector<int> minIndex;
+        QVector<int> maxIndex;
+    };
+
+    QVector<double> mKeys;
+    QVector<double> mValues;
+    QVector<Level> mLevels;     // mLevels[0] has bucketSize LOD_FACTOR
+};
+
+// Feeds a QCPGraph from a LodSeries on every key axis range change
+// Lives as a child of the graph, so it goes away with clearGraphs()
+class LodPlotBinder : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Attaches (or replaces) the series of a graph and loads the full range view
+    static LodPlotBinder *bind(QCPGraph *graph, QSharedPointer<const LodSeries> series);
+    static LodPlotBinder *find(QCPGraph *graph);
+
+    QSharedPointer<const LodSeries> series() const { return mSeries; }
+
+    // Fit to screen: key axis to the whole series (graph data then holds the global min/max,
+    // so rescaleAxes() afterwards fits the value axis correctly)
+    void showAll();
+
+public slots:
+    void refresh();
+
+private:
+    LodPlotBinder(QCPGraph *graph, QSharedPointer<const LodSeries> series);
+    void load(double lower, double upper);
+
+    QCPGraph *mGraph;
+    QSharedPointer<const LodSeries> mSeries;
+
+    // Last served window, pans inside the same buckets do not touch the graph
+    int mLastLevel = -1;
+    double mLastFirstKey = 0;
+    int mLastCount = -1;
+};
+
+#endif // LODSERIES_H
@@ -1,8 +1,13 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "packetdecoder.h"
+#include "signalprocessing.h"
+#include "lodseries.h"
+#include "asynclogger.h"
+#include "sampleexport.h"
 
-QFile MainWindow::logFile;
-QTextStream MainWindow::logStream;
+#include <algorithm>
+#include <numeric>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -25,20 +30,25 @@ MainWindow::MainWindow(QWidget *parent)
     ui->spinBox_samplingfrequency->setToolTip("Enter value from 1 to 20000");
     ui->spinBox_Inclinometer->setToolTip("Enter value from 1 to 1000");
 
+    // Live time domain plots are strip charts redrawn at a fixed frame rate, not once per packet
     uiUpdateTimer = new QTimer(this);
     uiUpdateTimer->setInterval(uiUpdateIntervalMs);
-//    connect(uiUpdateTimer, &QTimer::timeout, this, &MainWindow::onUiUpdateTimer);
-//    uiUpdateTimer->start();
+    connect(uiUpdateTimer, &QTimer::timeout, this, &MainWindow::refreshLivePlots);
+    uiUpdateTimer->start();
+    configureLiveStrips();
 
 
-    saveLimitTimer = new QTimer(this);
-    saveLimitTimer->setSingleShot(true);
+    // Save Live writes to disk in chunks (no in-memory history, no time limit)
+    QSettings liveSettings("settings.ini", QSettings::IniFormat);
+    liveWriter.setFlushInterval(liveSettings.value("LiveCapture/flushIntervalMs", 2000).toInt());
 
-    connect(saveLimitTimer, &QTimer::timeout, this, [this]() {
-        saveLive = false;
-        QMessageBox::information(this, "Limitation reached",
-                                 "Data saving is stopped due to memory limitation");
-    });
+    // Downloaded events are kept locally, reopening one skips the serial download
+    eventCache.setEnabled(liveSettings.value("EventCache/enabled", true).toBool());
+    eventCache.setDirectory(liveSettings.value("EventCache/dir", "eventcache").toString());
+    serialObj->setKeepEventResponse(eventCache.isEnabled());
+
+    // Damaged packets are left out of an event, optionally the whole event is downloaded again
+    eventRetries = qMax(0, liveSettings.value("Integrity/eventRetries", 0).toInt());
 
 
 
@@ -48,7 +58,11 @@ MainWindow::MainWindow(QWidget *parent)
     livePlotEnabled = ui->checkBox_livePlot->isChecked();
     });
 
-    connect(ui->pushButton_clear,&QPushButton::clicked,ui->textEdit_rawBytes,&QTextEdit::clear);
+    // Raw bytes console: bounded ring of lines, written in batches
+    ui->plainTextEdit_rawBytes->setMaxLines(liveSettings.value("RawConsole/maxLines", RawConsole::DEFAULT_MAX_LINES).toInt());
+    ui->plainTextEdit_rawBytes->setFlushInterval(liveSettings.value("RawConsole/flushIntervalMs",
+                                                                    RawConsole::DEFAULT_FLUSH_INTERVAL_MS).toInt());
+    connect(ui->pushButton_clear,&QPushButton::clicked,ui->plainTextEdit_rawBytes,&RawConsole::clearConsole);
 
     ui->comboBox_ports->addItems(serialObj->availablePorts());
 
@@ -65,6 +79,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     //gui display signal
     connect(serialObj,&serialPortHandler::guiDisplay,this,&MainWindow::showGuiData);
+    connect(serialObj,&serialPortHandler::eventDataReady,this,&MainWindow::showEventData);
+    connect(serialObj,&serialPortHandler::eventProgress,this,&MainWindow::showEventProgress);
 
     connect(serialObj,&serialPortHandler::liveData,this,&MainWindow::dataProcessing);
 
@@ -83,14 +99,9 @@ MainWindow::MainWindow(QWidget *parent)
                  "     Application Started");
     //#################################################
 
-    //Response Timer *********************************************##############
-    responseTimer = new QTimer(this);
-    responseTimer->setSingleShot(true); // Ensure it fires only once per use
-
-    // Connect the timer's timeout signal to a slot that handles the timeout
-    connect(responseTimer, &QTimer::timeout, this, &MainWindow::handleTimeout);
-
-    connect(serialObj, &serialPortHandler::dataReceived, this, &MainWindow::onDataReceived);
+    //Command queue, one timeout per command *********************##############
+    scheduler = new CommandScheduler(serialObj, this);
+    connect(scheduler, &CommandScheduler::commandTimedOut, this, &MainWindow::handleTimeout);
     //************************************************************##############
 
     writeToNotes("Pointer Size: "+QString::number(sizeof(void *))+" If it is 8 : 64 bit else 4 means 32 bit");
@@ -106,8 +117,8 @@ MainWindow::MainWindow(QWidget *parent)
 
 
     // Setting Table Get Log Events
-    ui->tableWidget_getLogEvents->setColumnCount(3);
-    ui->tableWidget_getLogEvents->setHorizontalHeaderLabels({"Event ID", "Start Time and Date", "End Time and Date"});
+    ui->tableWidget_getLogEvents->setColumnCount(4);
+    ui->tableWidget_getLogEvents->setHorizontalHeaderLabels({"Event ID", "Start Time and Date", "End Time and Date", "Local"});
 
     ui->tableWidget_getLogEvents->setEditTriggers(QAbstractItemView::NoEditTriggers);
 
@@ -117,6 +128,8 @@ MainWindow::MainWindow(QWidget *parent)
     header->setSectionResizeMode(0, QHeaderView::ResizeToContents);
     header->setSectionResizeMode(1, QHeaderView::Stretch);
     header->setSectionResizeMode(2, QHeaderView::Stretch);
+    header->setSectionResizeMode(3, QHeaderView::ResizeToContents);
+    ui->tableWidget_getLogEvents->setSelectionBehavior(QAbstractItemView::SelectRows);
 
 
 
@@ -127,54 +140,71 @@ MainWindow::~MainWindow()
     writeToNotes(+"    ******    "+QCoreApplication::applicationName() +
                  "     Application Closed");
     delete ui;
+    delete scheduler;
     delete serialObj;
-    delete responseTimer;
     closeLogFile();
 }
 
 void MainWindow::initializeLogFile() {
-    if (!logFile.isOpen()) {
-        logFile.setFileName("debug_notes.txt");
-        if (!logFile.open(QIODevice::Append | QIODevice::Text)) {
+    AsyncLogger &logger = AsyncLogger::instance();
+
+    // Level / flush interval come from settings.ini so hex dumps can be enabled in the field
+    QSettings settings("settings.ini", QSettings::IniFormat);
+    logger.setLevel(AsyncLogger::levelFromString(settings.value("Logging/level", "info").toString()));
+    logger.setFlushInterval(settings.value("Logging/flushIntervalMs", 50).toInt());
+    logger.setRotationPolicy(logRotationPolicy());
+
+    // Receive side logging: per response counters by default, per chunk lines / hex only on request
+    serialObj->setReceiveLogMode(serialPortHandler::receiveLogModeFromString(settings.value("Logging/receiveLog", "summary").toString()),
+                                 settings.value("Logging/receiveSampleBytes", 8).toInt());
+
+    // Binary packet trace next to the notes (decode with tools/tracedump)
+    QString traceFile;
+    if (settings.value("Trace/enabled", true).toBool())
+        traceFile = "debug_trace.bin";
+    logger.setTracePayloads(settings.value("Trace/payloads", true).toBool());
+
+    if (!logger.isOpen()) {
+        if (!logger.open("debug_notes.txt", traceFile)) {
             qCritical() << "Failed to open log file.";
-        } else {
-            logStream.setDevice(&logFile);
         }
     }
 }
 
 void MainWindow::resetLogFile() {
-    // Close the log file if it is open
-    if (logFile.isOpen()) {
-        logStream.flush();
-        logFile.close();
-    }
+    // Close the log file if it is open (pending lines are written first)
+    AsyncLogger::instance().close();
 
-    // Check if the file exists and delete it
-    QFile::remove("debug_notes.txt");
+    // Previous session is archived (within the retention budget) instead of deleted
+    AsyncLogger::instance().setRotationPolicy(logRotationPolicy());
+    AsyncLogger::instance().archiveFile("debug_notes.txt");
+    AsyncLogger::instance().archiveFile("debug_trace.bin");
 
     // Reinitialize the log file
     initializeLogFile();
 }
 
+LogRotationPolicy MainWindow::logRotationPolicy()
+{
+    QSettings settings("settings.ini", QSettings::IniFormat);
+    LogRotationPolicy policy;
+
+    policy.maxFileBytes      = qint64(settings.value("Logging/maxFileSizeMB", 20).toDouble() * 1024 * 1024);
+    policy.rotateIntervalSec = settings.value("Logging/rotateMinutes", 60).toInt() * 60;
+    policy.retentionBytes    = qint64(settings.value("Logging/retentionMB", 200).toDouble() * 1024 * 1024);
+    policy.maxArchives       = settings.value("Logging/maxArchives", 50).toInt();
+    policy.archiveDir        = settings.value("Logging/archiveDir", "logs").toString();
+    return policy;
+}
+
 
 void MainWindow::writeToNotes(const QString &data) {
-    if (!logFile.isOpen()) {
-        qCritical() << "Log file is not open.";
-        return;
-    }
-
-    // Add a timestamp for each entry
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
-    logStream << "[" << timestamp << "] " << data << Qt::endl;
-    logStream.flush(); // Ensure immediate write to disk
+    // Timestamped and written by the logger thread, no disk I/O on the caller
+    AsyncLogger::instance().log(LogLevel::Info, data);
 }
 
 void MainWindow::closeLogFile() {
-    if (logFile.isOpen()) {
-        logStream.flush();
-        logFile.close();
-    }
+    AsyncLogger::instance().close();
 }
 
 quint8 MainWindow::calculateChecksum(const QByteArray &data)
@@ -203,10 +233,15 @@ void MainWindow::refreshPorts()
 void MainWindow::onPortSelected(const QString &portName)
 {
     serialObj->setPORTNAME(portName);
+    currentPortName = portName;
 }
 
-void MainWindow::handleTimeout()
+void MainWindow::handleTimeout(quint8 msgId, const QString &label)
 {
+    // Commands queued behind the one that failed would only time out as well
+    scheduler->clear();
+    writeToNotes(QString("Command timed out: %1 (msgId 0x%2)").arg(label).arg(msgId, 2, 16, QChar('0')));
+
     QMessageBox::warning(this, "Timeout", "Hardware Not Responding!");
 
     if(dlgPlot){
@@ -215,13 +250,13 @@ void MainWindow::handleTimeout()
     }
 }
 
-void MainWindow::onDataReceived()
+void MainWindow::sendCommand(quint8 msgId, const QByteArray &command, const QString &label)
 {
-    // Stop the timer since data has been received
-    qDebug()<<"Hello stop it";
-    if (responseTimer->isActive()) {
-        responseTimer->stop();
-    }
+    CommandScheduler::Request request;
+    request.msgId = msgId;
+    request.bytes = command;
+    request.label = label;
+    scheduler->submit(request);
 }
 
 
@@ -752,95 +787,33 @@ void MainWindow::makePacket32UI(QList<QByteArray> &rawPacket32List)
     }
 }
 
-void MainWindow::makePacket4100AdxlTempList(QList<QByteArray> &rawPacket4100AdxlList,
-                                            QList<QByteArray> &rawPacketTemperatureList)
+void MainWindow::makePacket4100AdxlTempList(const QVector<double> &xAdxl, const QVector<double> &yAdxl,
+                                            const QVector<double> &zAdxl, const QVector<double> &temperatureValues)
 {
     QVector<double> sampleIndex;
-    QVector<double> xAdxl, yAdxl, zAdxl;
-    int globalSample = 1;
-
-    // --- ADXL Data Processing ---
-    for (int p = 0; p < rawPacket4100AdxlList.size(); ++p)
-    {
-        QByteArray packet = rawPacket4100AdxlList[p];
-
-        if (packet.size() < 20)
-        {
-            qDebug() << "Skipping too short ADXL packet:" << packet.size();
-            continue;
-        }
-
-        QByteArray trimmed = packet.mid(3);
-        if (trimmed.size() > 3) trimmed.chop(3); // remove footer
-        if (trimmed.size() > 2) trimmed.chop(2); // remove temperature bytes
-
-        int usableSize = trimmed.size();
-        if (usableSize < 6)
-        {
-            qDebug() << "Packet too short after trimming:" << usableSize;
-            continue;
-        }
 
-        for (int i = 0; i + 5 < usableSize; i += 6)
-        {
-            qint16 xRaw = (static_cast<quint8>(trimmed[i])     << 8) | static_cast<quint8>(trimmed[i + 1]);
-            qint16 yRaw = (static_cast<quint8>(trimmed[i + 2]) << 8) | static_cast<quint8>(trimmed[i + 3]);
-            qint16 zRaw = (static_cast<quint8>(trimmed[i + 4]) << 8) | static_cast<quint8>(trimmed[i + 5]);
-
-            // Keep last 12 bits only first 4 bits eliminate in a 16 bit integer
-            xRaw &= 0x0FFF;
-            yRaw &= 0x0FFF;
-            zRaw &= 0x0FFF;
-
-            sampleIndex.append(globalSample++);
-            xAdxl.append((xRaw * 3.3 * 2) / 4096.0);
-            yAdxl.append((yRaw * 3.3 * 2) / 4096.0);
-            zAdxl.append((zRaw * 3.3 * 2) / 4096.0);
-        }
-
-
-        qDebug() << "Processed ADXL packet" << p << ", extracted" << usableSize / 6 << "samples";
-    }
-    for(int g=0;g<xAdxl.size();g++){
-        xAdxl[g]=(xAdxl[g]-1.65)/0.0063;
-        yAdxl[g]=(yAdxl[g]-1.65)/0.0063;
-        zAdxl[g]=(zAdxl[g]-1.65)/0.0063;
-
-    }
+    sampleIndex.resize(xAdxl.size());
+    for (int g = 0; g < sampleIndex.size(); g++)
+        sampleIndex[g] = g + 1;
 
     qDebug() << "Total ADXL samples:" << sampleIndex.size();
 
 
-    // --- Temperature Data Processing ---
+    // --- Temperature, one per ADXL packet ---
     QVector<double> tempIndex;
-    QVector<double> temperatureValues;
-
-    for (int i = 0; i < rawPacketTemperatureList.size(); ++i)
-    {
-        QByteArray tempBytes = rawPacketTemperatureList[i];
-        if (tempBytes.size() < 2)
-        {
-            qDebug() << "Skipping short temperature packet:" << tempBytes.size();
-            continue;
-        }
 
-        quint16 tempRaw = (static_cast<quint8>(tempBytes[0]) << 8) | static_cast<quint8>(tempBytes[1]);
-        tempIndex.append(i+1);
-
-        // Keep first 14 bits only last 2 bits eliminate in a 16 bit integer
-        tempRaw &= ~0x0003;
-
-        temperatureValues.append(-46.85 + (175.72 * tempRaw) / 65536.0);
-    }
+    tempIndex.resize(temperatureValues.size());
+    for (int i = 0; i < tempIndex.size(); ++i)
+        tempIndex[i] = i + 1;
 
     qDebug() << "Total temperature samples:" << temperatureValues.size();
 
-    // --- Plotting Helper ---
+    // --- Plotting Helper (min/max pyramid, graph only holds what the visible width needs) ---
     auto plotGraph = [](QCustomPlot *plot, const QVector<double> &x, const QVector<double> &y)
     {
         if (plot->graphCount() > 0)
         {
-            plot->graph(0)->setData(x, y);
+            LodPlotBinder::bind(plot->graph(0), QSharedPointer<const LodSeries>::create(x, y));
             plot->rescaleAxes();
             plot->replot();
         }
@@ -866,95 +839,41 @@ void MainWindow::makePacket4100AdxlTempList(QList<QByteArray> &rawPacket4100Adxl
     this->finalTempIndex = tempIndex;
     this->finalTemperature = temperatureValues;
 
-    // --- FFT Plot ---
+    // --- FFT Plot (X/Y/Z transformed concurrently, plotted here on the GUI thread) ---
     double Fs = adxlFreq;
-    qDebug() << "Debug 1";
 
     try {
-        computeAndPlotFFT(xAdxl, Fs, ui->customPlot_adxl_x_FFT);
+        const QVector<SignalProcessing::Spectrum> spectra =
+                SignalProcessing::computeSpectra({ xAdxl, yAdxl, zAdxl }, Fs);
+
+        plotSpectrum(spectra[0], Fs, ui->customPlot_adxl_x_FFT);
+        plotSpectrum(spectra[1], Fs, ui->customPlot_adxl_y_FFT);
+        plotSpectrum(spectra[2], Fs, ui->customPlot_adxl_z_FFT);
     }
     catch (std::exception &ex) {
-        qCritical() << "computeAndPlotFFT exception:" << ex.what();
+        qCritical() << "computeSpectra exception:" << ex.what();
     }
     catch (...) {
-        qCritical() << "computeAndPlotFFT unknown crash";
+        qCritical() << "computeSpectra unknown crash";
     }
 
-    qDebug() << "Debug 2";
-
-
-    computeAndPlotFFT(yAdxl, Fs, ui->customPlot_adxl_y_FFT);
-    computeAndPlotFFT(zAdxl, Fs, ui->customPlot_adxl_z_FFT);
-
 }
-void MainWindow::makePacket4100InclList(QList<QByteArray> &rawPacket4100InclList)
+void MainWindow::makePacket4100InclList(const QVector<double> &inclX, const QVector<double> &inclY)
 {
     QVector<double> sampleIndex;
-    QVector<double> inclX, inclY;
-    int globalSample = 1;
-
-    for (int p = 0; p < rawPacket4100InclList.size(); ++p)
-    {
-        QByteArray packet = rawPacket4100InclList[p];
-
-        if (packet.size() < 20)
-        {
-            qDebug() << "Skipping too short Inclinometer packet:" << packet.size();
-            continue;
-        }
-
-        // Remove header (3 bytes)
-        QByteArray trimmed = packet.mid(3);
-
-        // Remove footer (3 bytes)
-        if (trimmed.size() > 3)
-            trimmed.chop(3);
-
-        // Remove last 2 dummy bytes before footer
-        if (trimmed.size() > 2)
-            trimmed.chop(2);
-
-        int usableSize = trimmed.size();
-        if (usableSize < 4)
-        {
-            qDebug() << "Packet too short after trimming:" << usableSize;
-            continue;
-        }
-
-        // Process each 4-byte sample (Xg, Yg)
-        for (int i = 0; i + 3 < usableSize; i += 4)
-        {
-            qint16 xRaw = (static_cast<quint8>(trimmed[i + 1])     << 8) | static_cast<quint8>(trimmed[i]);
-            qint16 yRaw = (static_cast<quint8>(trimmed[i + 3]) << 8) | static_cast<quint8>(trimmed[i + 2]);
-
-            // Convert to g-values
-            double xg = (xRaw * 0.031) / 1000.0;
-            double yg = (yRaw * 0.031) / 1000.0;
-
-            // Clamp to [-1, 1]
-            xg = std::max(-1.0, std::min(1.0, xg));
-            yg = std::max(-1.0, std::min(1.0, yg));
-
-            // Convert to degrees
-            double xDeg = std::asin(xg) * (180.0 / M_PI);
-            double yDeg = std::asin(yg) * (180.0 / M_PI);
-
-            sampleIndex.append(globalSample++);
-            inclX.append(xDeg);
-            inclY.append(yDeg);
-        }
 
-        qDebug() << "Processed Incl packet" << p << ", extracted" << usableSize / 4 << "samples";
-    }
+    sampleIndex.resize(inclX.size());
+    for (int g = 0; g < sampleIndex.size(); g++)
+        sampleIndex[g] = g + 1;
 
     qDebug() << "Total Incl samples:" << sampleIndex.size();
 
-    // --- Plotting ---
+    // --- Plotting (min/max pyramid, see lodseries.h) ---
     auto plotGraph = [](QCustomPlot *plot, const QVector<double> &x, const QVector<double> &y)
     {
         if (plot->graphCount() > 0)
         {
-            plot->graph(0)->setData(x, y);
+            LodPlotBinder::bind(plot->graph(0), QSharedPointer<const LodSeries>::create(x, y));
             plot->rescaleAxes();
             plot->replot();
         }
@@ -980,6 +899,68 @@ void MainWindow::saveAllSensorDataToExcel(const QVector<double> &adxlIndex,
                                           const QVector<double> &inclX,
                                           const QVector<double> &inclY)
 {
+    // ---------------- SIMPLE FILE DIALOG FIRST ----------------
+    QString defaultName = QString("SensorData_%1.xlsx")
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+
+    QString desktopPath = QStandardPaths::writableLocation(QStandardPaths::DesktopLocation);
+
+    QString selectedFilter;
+    QString fullPath = QFileDialog::getSaveFileName(
+                this,
+                "Save Sensor Data",
+                desktopPath + "/" + defaultName,
+                SampleExport::fileFilter(),
+                &selectedFilter
+    );
+
+    if (fullPath.isEmpty()) {
+        QMessageBox::information(this, "Save Cancelled",
+                                 "User cancelled the file save operation.");
+        return;
+    }
+
+    const SampleExport::Format format = SampleExport::formatFor(fullPath, selectedFilter);
+    if (!fullPath.endsWith(SampleExport::suffix(format), Qt::CaseInsensitive))
+        fullPath += SampleExport::suffix(format);
+
+    // ---------------- CSV / PARQUET (streamed from the vectors, no workbook) ----------------
+    if (format != SampleExport::Format::Xlsx)
+    {
+        QVector<double> inclSampleIndex(inclX.size());
+        std::iota(inclSampleIndex.begin(), inclSampleIndex.end(), 0.0);
+
+        QVector<SampleExport::Column> columns;
+        columns << SampleExport::Column("Samples", adxlIndex.constData(), qMin(adxlIndex.size(), xAdxl.size()))
+                << SampleExport::Column("ADXL X (g)", xAdxl)
+                << SampleExport::Column("ADXL Y (g)", yAdxl)
+                << SampleExport::Column("ADXL Z (g)", zAdxl)
+                << SampleExport::Column("Temp Index", tempIndex.constData(), qMin(tempIndex.size(), temperature.size()))
+                << SampleExport::Column("Temperature (°C)", temperature)
+                << SampleExport::Column("Incl Index", inclSampleIndex)
+                << SampleExport::Column("Incl X (deg)", inclX)
+                << SampleExport::Column("Incl Y (deg)", inclY);
+
+        SampleExport::Metadata metadata;
+        metadata << qMakePair(QString("Event ID"), eventId)
+                 << qMakePair(QString("StartTime"), formattedStart)
+                 << qMakePair(QString("EndTime"), formattedEnd)
+                 << qMakePair(QString("ADXL freq"), QString::number(adxlFreq))
+                 << qMakePair(QString("Inclinometer freq"), QString::number(InclinometerFreq));
+
+        QString error;
+        bool ok = (format == SampleExport::Format::Csv)
+                ? SampleExport::writeCsv(fullPath, columns, metadata, &error)
+                : SampleExport::writeParquet(fullPath, columns, metadata, &error);
+        if (ok)
+            QMessageBox::information(this, "Success",
+                                     "Sensor data saved successfully at:\n" + fullPath);
+        else
+            QMessageBox::critical(this, "Save Failed",
+                                  "Failed to save " + fullPath + "\n" + error);
+        return;
+    }
+
     QXlsx::Document xlsx;
 
     // ---------- HEADER FORMAT ----------
@@ -1029,58 +1010,25 @@ void MainWindow::saveAllSensorDataToExcel(const QVector<double> &adxlIndex,
     xlsx.setColumnWidth(6, 7, 16);   // Temperature
     xlsx.setColumnWidth(9, 11, 16);  // Inclinometer
 
-    int row = 6;
+    const int firstDataRow = 6;
 
-    // ------------ ADXL Values --------------
-    for (int i = 0; i < xAdxl.size(); i++)
-    {
-        xlsx.write(row, 1, adxlIndex[i], dataFormat);
-        xlsx.write(row, 2, xAdxl[i],     dataFormat);
-        xlsx.write(row, 3, yAdxl[i],     dataFormat);
-        xlsx.write(row, 4, zAdxl[i],     dataFormat);
-        row++;
-    }
+    // ------------ ADXL Values (whole columns, format resolved once) --------------
+    xlsx.writeColumn(firstDataRow, 1, adxlIndex.constData(), qMin(adxlIndex.size(), xAdxl.size()), dataFormat);
+    xlsx.writeColumn(firstDataRow, 2, xAdxl, dataFormat);
+    xlsx.writeColumn(firstDataRow, 3, yAdxl, dataFormat);
+    xlsx.writeColumn(firstDataRow, 4, zAdxl, dataFormat);
 
     // ------------ Temperature Values --------------
-    int tRow = 6;
-    for (int i = 0; i < temperature.size(); i++)
-    {
-        xlsx.write(tRow, 6, tempIndex[i],   dataFormat);
-        xlsx.write(tRow, 7, temperature[i], dataFormat);
-        tRow++;
-    }
+    xlsx.writeColumn(firstDataRow, 6, tempIndex.constData(), qMin(tempIndex.size(), temperature.size()), dataFormat);
+    xlsx.writeColumn(firstDataRow, 7, temperature, dataFormat);
 
     // ------------ Inclinometer Values --------------
-    int iRow = 6;
-    for (int i = 0; i < inclX.size(); i++)
-    {
-        xlsx.write(iRow, 9,  i, dataFormat);
-        xlsx.write(iRow, 10, inclX[i],     dataFormat);
-        xlsx.write(iRow, 11, inclY[i],     dataFormat);
-        iRow++;
-    }
-
-    // ---------------- SIMPLE FILE DIALOG ----------------
-    QString defaultName = QString("SensorData_%1.xlsx")
-            .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
-
-    QString desktopPath = QStandardPaths::writableLocation(QStandardPaths::DesktopLocation);
-
-    QString fullPath = QFileDialog::getSaveFileName(
-                this,
-                "Save Sensor Data",
-                desktopPath + "/" + defaultName,
-                "Excel Files (*.xlsx)"
-    );
-
-    if (fullPath.isEmpty()) {
-        QMessageBox::information(this, "Save Cancelled",
-                                 "User cancelled the file save operation.");
-        return;
-    }
-
-    if (!fullPath.endsWith(".xlsx", Qt::CaseInsensitive))
-        fullPath += ".xlsx";
+    // Running index, as the per row loop wrote it
+    QVector<double> inclSampleIndex(inclX.size());
+    std::iota(inclSampleIndex.begin(), inclSampleIndex.end(), 0.0);
+    xlsx.writeColumn(firstDataRow, 9,  inclSampleIndex, dataFormat);
+    xlsx.writeColumn(firstDataRow, 10, inclX,     dataFormat);
+    xlsx.writeColumn(firstDataRow, 11, inclY,     dataFormat);
 
     // ---------------- SAVE ----------------
     if (xlsx.saveAs(fullPath)) {
@@ -1109,14 +1057,6 @@ void MainWindow::initializeSensorVectors()
     finalInclIndex.clear();
     finalInclX.clear();
     finalInclY.clear();
-
-    //--- Live Data----
-
-    full_xAdxl.clear();
-    full_yAdxl.clear();
-    full_zAdxl.clear();
-    fullInclXL.clear();
-    fullInclYL.clear();
 }
 
 
@@ -1150,217 +1090,166 @@ void MainWindow::portStatus(const QString &data)
         QMessageBox::critical(this,"Error",data);
     }
 
-    ui->textEdit_rawBytes->append(data);
+    ui->plainTextEdit_rawBytes->appendLine(data);
 }
 
-void MainWindow::showGuiData(const QByteArray &byteArrayData)
+void MainWindow::showEventProgress(qint64 bytesReceived, int adxlPackets, int inclPackets)
 {
-    QByteArray data = byteArrayData;
+    // Packets are already decoded as they arrive, show how far the download is
+    if (!dlgPlot)
+        return;
 
-    // Get Event Data Command mdgId 0x01
-    if(data.startsWith(QByteArray::fromHex("AA BB")) && data.endsWith(QByteArray::fromHex("AA BB CC DD FF")))
+    if (QLabel *label = dlgPlot->findChild<QLabel *>())
     {
-        int i = 0;
-
-        QList<QByteArray> packet32List;
-        QList<QByteArray> packet4100AdxlList;
-        QList<QByteArray> packet4100InclList;
-        QList<QByteArray> packetTemperatureList;
-
-        int invalidHeaderCount = 0;
-
-        while (i < data.size())
-        {
-            //  Make sure we have at least 3 bytes for a header
-            if (i + 3 > data.size())
-                break;
-
-            QByteArray header = data.mid(i, 3);
-
-            // --- Case 1: Packet32 ---
-            if (header.startsWith(QByteArray::fromHex("AA BB")))
-            {
-                if (i + 32 <= data.size())
-                {
-                    QByteArray packet32 = data.mid(i, 32);
-
-                    packet32List.append(packet32);
-                    i += 32;
-                    continue;
-                }
-                else break; // incomplete packet at end
-            }
-
-            // --- Case 2: Packet4100_ADXL ---
-            else if (header == QByteArray::fromHex("CC DD FF"))
-            {
-                if (i + 4100 <= data.size())
-                {
-                    QByteArray packet4100 = data.mid(i, 4100);
-                    if (packet4100.endsWith(QByteArray::fromHex("FF EE FF")))
-                    {
-                        if(packet4100.contains(QByteArray::fromHex("FF FF FF FF FF FF")))
-                        {
-                            // Special condition FF's checking
-                            QByteArray specialPacket = packet4100;
-
-                            qDebug()<<"Consecutive FF's detected at packet [ADXL]: "+QString::number(packet4100AdxlList.size());
-                            writeToNotes("Consecutive FF's detected at packet [ADXL]: " + QString::number(packet4100AdxlList.size()));
-
-
-                            int fIndex = specialPacket.indexOf(QByteArray::fromHex("FF FF FF FF FF FF"));
-                            qDebug()<<fIndex<<" :fIndex";
-
-                            qDebug()<< "Removing ff bytes count [ADXL]: " << (specialPacket.size() - fIndex) - 5;
-                            writeToNotes("Removing ff bytes count [ADXL]: " + QString::number((specialPacket.size() - fIndex) - 5));
-
-                            specialPacket.remove(fIndex,(specialPacket.size() - fIndex) - 5);
-
-
-                            packet4100AdxlList.append(specialPacket);
-                            qDebug()<<specialPacket.toHex(' ').toUpper()<<" :specialPacket";
-
-                            // writeToNotes Log
-                            writeToNotes("fIndex (start of FFs) [ADXL]: " + QString::number(fIndex));
-                            writeToNotes("specialPacket [ADXL]: " + specialPacket.toHex(' ').toUpper());
-                        }
-                        else
-                        {
-                            // Normal condition
-                            packet4100AdxlList.append(packet4100);
-                        }
-
-                        // Extract last 2 bytes before footer as temperature
-                        QByteArray tempBytes = packet4100.mid(4100 - 5, 2);
-                        packetTemperatureList.append(tempBytes);
-                    }
-                    else
-                    {
-                        invalidHeaderCount++;
-                    }
-                    i += 4100;
-                    continue;
-                }
-                else break;
-            }
-
-            // --- Case 3: Packet4100_INCLINOMETER ---
-            else if (header == QByteArray::fromHex("EE FF FF"))
-            {
-                if (i + 4100 <= data.size())
-                {
-                    QByteArray packet4100 = data.mid(i, 4100);
-                    if (packet4100.endsWith(QByteArray::fromHex("FF CC DD")))
-                    {
-                        if(packet4100.contains(QByteArray::fromHex("FF FF FF FF FF FF")))
-                        {
-                            // Special condition FF's checking
-                            QByteArray specialPacket = packet4100;
-
-                            qDebug()<<"Consecutive FF's detected at packet [INCLINOMETER]: "+QString::number(packet4100InclList.size());
-                            writeToNotes("Consecutive FF's detected at packet [INCLINOMETER]: " + QString::number(packet4100InclList.size()));
-
+        const QString title = batchTotal > 0
+                ? QString("⌛ Downloading event %1 / %2 ...").arg(batchDone + 1).arg(batchTotal)
+                : QString("⌛ Please Wait Loading Plot !!!");
+        label->setText(QString("%1\n%2 KB received, %3 ADXL / %4 Inclinometer packets")
+                       .arg(title).arg(bytesReceived / 1024).arg(adxlPackets).arg(inclPackets));
+        dlgPlot->setFixedSize(dlgPlot->sizeHint());
+    }
+}
 
-                            int fIndex = specialPacket.indexOf(QByteArray::fromHex("FF FF FF FF FF FF"));
-                            qDebug()<<fIndex<<" :fIndex";
+void MainWindow::showEventData(const EventStreamParser::Event &event)
+{
+    // Downloads are answered in the order they were queued
+    const EventRequest request = eventRequests.isEmpty() ? EventRequest() : eventRequests.head();
 
-                            qDebug()<< "Removing ff bytes count [INCLINOMETER]: " << (specialPacket.size() - fIndex) - 5;
-                            writeToNotes("Removing ff bytes count [INCLINOMETER]: " + QString::number((specialPacket.size() - fIndex) - 5));
+    devicePadding[currentPortName].add(event.padding);
+    logPaddingStats("Event", event.padding);
 
-                            specialPacket.remove(fIndex,(specialPacket.size() - fIndex) - 5);
+    if (!event.damaged.isEmpty())
+    {
+        logDamagedPackets(request.eventId, event);
 
+        // Only whole events can be requested again, [Integrity] eventRetries (default 0) downloads it once more
+        if (!eventRequests.isEmpty() && request.attempt < eventRetries)
+        {
+            writeToNotes(QString("Event %1 requested again (attempt %2 of %3)")
+                         .arg(request.eventId).arg(request.attempt + 2).arg(eventRetries + 1));
+            eventRequests.head().retried = true;
+            requestEvent(request.eventId, request.display, request.attempt + 1);
+            return;
+        }
 
-                            packet4100InclList.append(specialPacket);
-                            qDebug()<<specialPacket.toHex(' ').toUpper()<<" :specialPacket";
+        // Kept out of the cache, the next Get Event Data downloads it again
+        if (!eventRequests.isEmpty())
+            eventRequests.head().damaged = true;
+    }
 
-                            // writeToNotes Log
-                            writeToNotes("fIndex (start of FFs) [INCLINOMETER]: " + QString::number(fIndex));
-                            writeToNotes("specialPacket [INCLINOMETER]: " + specialPacket.toHex(' ').toUpper());
-                        }
-                        else
-                        {
-                            // Normal condition
-                            packet4100InclList.append(packet4100);
-                        }
-                    }
-                    else
-                    {
-                        invalidHeaderCount++;
-                    }
-                    i += 4100;
-                    continue;
-                }
-                else break;
-            }
+    if (eventCache.isEnabled() && !event.response.isEmpty() && event.damaged.isEmpty())
+    {
+        EventCache::Entry entry;
+        entry.device = currentPortName;
+        entry.eventId = request.eventId;
+        entry.response = event.response;
+
+        QString error;
+        if (eventCache.store(entry, &error))
+            markCachedEvents();
+        else
+            writeToNotes("Event cache: unable to store event " + QString::number(request.eventId) + " : " + error);
+    }
 
-            // --- Case 4: Unknown header ---
-            else
-            {
-                // Unknown header found — treat as invalid frame
-                int next = qMin(i + 4100, data.size());  // move by full packet size
-                QByteArray maybeFooter = data.mid(next - 3, 3);
+    if (request.display)
+        displayEvent(event);
+}
 
-                qDebug() << "Unknown header" << header.toHex()
-                         << "possible footer" << maybeFooter.toHex();
+void MainWindow::logDamagedPackets(quint16 eventId, const EventStreamParser::Event &event)
+{
+    int skippedBytes = 0;
+    for (const PacketDecoder::DamagedPacket &damaged : event.damaged)
+    {
+        const QString what = damaged.type == PacketDecoder::PacketType::Adxl ? "ADXL packet, footer mismatch"
+                           : damaged.type == PacketDecoder::PacketType::Incl ? "Inclinometer packet, footer mismatch"
+                           : "unknown header";
+        qDebug() << "Damaged bytes at" << damaged.offset << what << "skipped:" << damaged.skippedBytes;
+        if (damaged.type == PacketDecoder::PacketType::Unknown)
+            writeToNotes("Unknown header: " + damaged.header.toHex(' ').toUpper() + " at " + QString::number(damaged.offset));
+        writeToNotes(QString("Damaged bytes at %1 (%2): %3 bytes skipped")
+                     .arg(damaged.offset).arg(what).arg(damaged.skippedBytes));
+        skippedBytes += damaged.skippedBytes;
+    }
 
-                writeToNotes("Unknown header: " + header.toHex(' ').toUpper() +
-                              " | possible footer: " + maybeFooter.toHex(' ').toUpper());
+    writeToNotes(QString("Event %1: %2 damaged packet(s), %3 bytes left out, %4 ADXL / %5 Inclinometer packets decoded")
+                 .arg(eventId).arg(event.damaged.size()).arg(skippedBytes).arg(event.adxlPackets).arg(event.inclPackets));
+}
 
-                invalidHeaderCount++;
-                i = next;  // skip full 4100 bytes
-            }
-        }
+void MainWindow::displayEvent(const EventStreamParser::Event &event)
+{
+    // Special condition FF's logging
+    for (const PacketDecoder::PaddingInfo &info : event.paddingList)
+    {
+        const QString sensor = info.adxl ? "[ADXL]" : "[INCLINOMETER]";
+        qDebug() << "Consecutive FF's detected at packet" << sensor << info.packetIndex
+                 << "fIndex:" << info.fIndex << "removed:" << info.removedBytes;
+        writeToNotes("Consecutive FF's detected at packet " + sensor + ": " + QString::number(info.packetIndex));
+        writeToNotes("Removing ff bytes count " + sensor + ": " + QString::number(info.removedBytes));
+        writeToNotes("fIndex (start of FFs) " + sensor + ": " + QString::number(info.fIndex));
+    }
+
+    // Summary logs
+    qDebug() << " Packet32 count:" << event.packet32List.size();
+    qDebug() << " Packet4100 ADXL count:" << event.adxlPackets;
+    qDebug() << " Packet4100 Inclinometer count:" << event.inclPackets;
+    qDebug() << " Temperature samples:" << event.temperature.size();
+    qDebug() << " Invalid headers:" << event.invalidHeaderCount;
+
+    if(event.temperature.size() != 147)
+    {
+        qDebug()<<"Lesser Adxl/Temperature Packets Detected With Size : "<<event.temperature.size();
+        writeToNotes("Lesser Adxl/Temperature Packets Detected With Size : "+QString::number(event.temperature.size()));
 
-        // Summary logs
-        qDebug() << " Packet32 count:" << packet32List.size();
-        qDebug() << " Packet4100 ADXL count:" << packet4100AdxlList.size();
-        qDebug() << " Packet4100 Inclinometer count:" << packet4100InclList.size();
-        qDebug() << " Temperature samples:" << packetTemperatureList.size();
-        qDebug() << " Invalid headers:" << invalidHeaderCount;
+    }
 
-        if(packetTemperatureList.size() != 147)
-        {
-            qDebug()<<"Lesser Adxl/Temperature Packets Detected With Size : "<<packetTemperatureList.size();
-            writeToNotes("Lesser Adxl/Temperature Packets Detected With Size : "+QString::number(packetTemperatureList.size()));
+    // writeToNotes log
+    writeToNotes("Packet32 count: " + QString::number(event.packet32List.size()));
+    writeToNotes("Packet4100 ADXL count: " + QString::number(event.adxlPackets));
+    writeToNotes("Packet4100 Inclinometer count: " + QString::number(event.inclPackets));
+    writeToNotes("Temperature samples: " + QString::number(event.temperature.size()));
+    writeToNotes("Invalid headers: " + QString::number(event.invalidHeaderCount));
 
-        }
 
-        // writeToNotes log
-        writeToNotes("Packet32 count: " + QString::number(packet32List.size()));
-        writeToNotes("Packet4100 ADXL count: " + QString::number(packet4100AdxlList.size()));
-        writeToNotes("Packet4100 Inclinometer count: " + QString::number(packet4100InclList.size()));
-        writeToNotes("Temperature samples: " + QString::number(packetTemperatureList.size()));
-        writeToNotes("Invalid headers: " + QString::number(invalidHeaderCount));
+    //Making Packets
+    QList<QByteArray> packet32List = event.packet32List;
+    makePacket32UI(packet32List);
+    makePacket4100AdxlTempList(event.xAdxl, event.yAdxl, event.zAdxl, event.temperature);
+    makePacket4100InclList(event.inclX, event.inclY);
 
+       if (dlgPlot) {
+            dlgPlot->close();
+            dlgPlot = nullptr;
+          }
 
-        //Making Packets
-        makePacket32UI(packet32List);
-        makePacket4100AdxlTempList(packet4100AdxlList,packetTemperatureList);
-        makePacket4100InclList(packet4100InclList);
 
-           if (dlgPlot) {
-                dlgPlot->close();
-                dlgPlot = nullptr;
-              }
+    QDialog *excelSavingDialog = createPleaseWaitDialog("⏳ Please Wait, Data Saving ...");
 
+    saveAllSensorDataToExcel(
+        finalAdxlIndex, finalXAdxl, finalYAdxl, finalZAdxl,
+        finalTempIndex, finalTemperature,
+        finalInclIndex, finalInclX, finalInclY
+    );
 
-        QDialog *excelSavingDialog = createPleaseWaitDialog("⏳ Please Wait, Data Saving ...");
+    if(excelSavingDialog)
+    {
+        excelSavingDialog->close();
+        excelSavingDialog = nullptr;
+    }
 
-        saveAllSensorDataToExcel(
-            finalAdxlIndex, finalXAdxl, finalYAdxl, finalZAdxl,
-            finalTempIndex, finalTemperature,
-            finalInclIndex, finalInclX, finalInclY
-        );
+    if (!event.damaged.isEmpty())
+    {
+        QMessageBox::warning(this, "Damaged Packets",
+                             QString("%1 damaged packet(s) were left out of this event, see the notes for details")
+                             .arg(event.damaged.size()));
+    }
+}
 
-        if(excelSavingDialog)
-        {
-            excelSavingDialog->close();
-            excelSavingDialog = nullptr;
-        }
+void MainWindow::showGuiData(const QByteArray &byteArrayData)
+{
+    QByteArray data = byteArrayData;
 
-    }
-    // Get Event Data Command Nack Condition mdgId 0x01
-    else if(data.startsWith(QByteArray::fromHex("53 54 45 FF")))
+    // Get Event Data Command Nack Condition mdgId 0x01 (the event itself arrives through showEventData)
+    if(data.startsWith(QByteArray::fromHex("53 54 45 FF")))
     {
         QMessageBox::warning(this,"Error","Invalid Event Id");
         writeToNotes(" ### Invalid Event Id ###");
@@ -1407,9 +1296,9 @@ void MainWindow::showGuiData(const QByteArray &byteArrayData)
         // Clear and setup table
         ui->tableWidget_getLogEvents->clear();
         ui->tableWidget_getLogEvents->setRowCount(0);
-        ui->tableWidget_getLogEvents->setColumnCount(3);
+        ui->tableWidget_getLogEvents->setColumnCount(4);
         ui->tableWidget_getLogEvents->setHorizontalHeaderLabels(
-            QStringList() << "Event ID" << "Start Time and Date" << "End Time and Date"
+            QStringList() << "Event ID" << "Start Time and Date" << "End Time and Date" << "Local"
         );
 
         int segmentCount = 0;
@@ -1446,23 +1335,9 @@ void MainWindow::showGuiData(const QByteArray &byteArrayData)
                 quint8 lsb = static_cast<quint8>(packet[3]);
                 quint16 eventId = (msb << 8) | lsb;
 
-                // --- Extract Start Time ---
-                QByteArray startTimeBytes = packet.mid(20, 6);
-                QStringList startParts;
-                for (auto b : startTimeBytes)
-                    startParts.append(QString("%1").arg(static_cast<quint8>(b), 2, 10, QChar('0')));
-                QString formattedStart = QString("%1:%2:%3 %4/%5/%6")
-                    .arg(startParts[0]).arg(startParts[1]).arg(startParts[2])
-                    .arg(startParts[3]).arg(startParts[4]).arg(startParts[5]);
-
-                // --- Extract End Time ---
-                QByteArray endTimeBytes = packet.mid(26, 6);
-                QStringList endParts;
-                for (auto b : endTimeBytes)
-                    endParts.append(QString("%1").arg(static_cast<quint8>(b), 2, 10, QChar('0')));
-                QString formattedEnd = QString("%1:%2:%3 %4/%5/%6")
-                    .arg(endParts[0]).arg(endParts[1]).arg(endParts[2])
-                    .arg(endParts[3]).arg(endParts[4]).arg(endParts[5]);
+                // --- Start / End Time (same strings the event cache compares against) ---
+                const QString formattedStart = EventCache::formatTime(packet.constData() + 20);
+                const QString formattedEnd = EventCache::formatTime(packet.constData() + 26);
 
                 // --- Insert into Table ---
                 int row = ui->tableWidget_getLogEvents->rowCount();
@@ -1477,15 +1352,7 @@ void MainWindow::showGuiData(const QByteArray &byteArrayData)
             // --- Count trailing FFs before the footer ---
             int footerIndex = segment.indexOf(QByteArray::fromHex("65 6E 64"));
             if (footerIndex > 0)
-            {
-                for (int i = footerIndex - 1; i >= 0; --i)
-                {
-                    if (static_cast<quint8>(segment[i]) == 0xFF)
-                        totalFFCount++;
-                    else
-                        break;
-                }
-            }
+                totalFFCount += PaddingScanner::trailingFF(segment.constData(), footerIndex);
 
         }
 
@@ -1496,6 +1363,8 @@ void MainWindow::showGuiData(const QByteArray &byteArrayData)
         writeToNotes("Segments found: " + QString::number(segmentCount));
         writeToNotes("Total packets parsed: " + QString::number(totalPacketsParsed));
         writeToNotes("Trailing FF bytes count: " + QString::number(totalFFCount));
+
+        markCachedEvents();
     }
 
 
@@ -1702,9 +1571,25 @@ void MainWindow::on_pushButton_getEventData_clicked()
     initializeSensorVectors();
     on_pushButton_clearPoints_fft_clicked();
 
-    // Start the timeout timer
-    responseTimer->start(2000); // 2 Sec timer
+    // Seen before with the start time the Get Log Events table lists : no serial download
+    // (not listed, e.g. the table wasn't loaded : downloaded, a reused event id can't be told apart)
+    EventCache::Entry cached;
+    if (eventCache.load(currentPortName, eventId, cached, logEventStart(eventId)))
+    {
+        qDebug() << "Event" << eventId << "opened from" << eventCache.filePath(currentPortName, eventId);
+        writeToNotes("Event " + QString::number(eventId) + " opened from the local cache (saved "
+                     + cached.savedAt.toString(Qt::ISODate) + ")");
+        displayEvent(EventStreamParser::decodeResponse(cached.response));
+        return;
+    }
+
+    dlgPlot = createPleaseWaitDialog("⌛ Please Wait Loading Plot !!!");
 
+    requestEvent(eventId, true);
+}
+
+void MainWindow::requestEvent(quint16 eventId, bool display, int attempt)
+{
     QByteArray command;
 
     command.append(0x53); //1
@@ -1722,12 +1607,151 @@ void MainWindow::on_pushButton_getEventData_clicked()
     qDebug() << "Get Event Data cmd sent : " + hexBytes(command);
     writeToNotes("Get Event Data cmd sent : " + hexBytes(command));
 
-    emit sendMsgId(0x01);
+    EventRequest request;
+    request.eventId = eventId;
+    request.display = display;
+    request.attempt = attempt;
+    eventRequests.enqueue(request);
+
+    CommandScheduler::Request scheduled;
+    scheduled.msgId = 0x01;
+    scheduled.bytes = command;
+    scheduled.label = "Get Event Data " + QString::number(eventId);
+    scheduler->submit(scheduled, [this](const CommandScheduler::Result &result) {
+        // The event itself went through showEventData already
+        const EventRequest request = eventRequests.isEmpty() ? EventRequest() : eventRequests.dequeue();
+
+        // Counted once its retry finishes
+        if (request.retried)
+            return;
+
+        if (!request.display)
+            eventDownloadFinished(result.status == CommandScheduler::Status::Completed
+                                  && result.response.isEmpty()         // NACK : "53 54 45 FF"
+                                  && !request.damaged);
+    });
+}
 
-    dlgPlot = createPleaseWaitDialog("⌛ Please Wait Loading Plot !!!");
+QString MainWindow::logEventStart(quint16 eventId) const
+{
+    for (int row = 0; row < ui->tableWidget_getLogEvents->rowCount(); ++row)
+    {
+        QTableWidgetItem *id = ui->tableWidget_getLogEvents->item(row, 0);
+        QTableWidgetItem *start = ui->tableWidget_getLogEvents->item(row, 1);
+        if (id && start && id->text().toInt() == eventId)
+            return start->text();
+    }
+    return QString();
+}
+
+void MainWindow::markCachedEvents()
+{
+    QTableWidget *table = ui->tableWidget_getLogEvents;
+    if (table->columnCount() < 4)
+        return;
 
-    serialObj->writeData(command);
+    for (int row = 0; row < table->rowCount(); ++row)
+    {
+        QTableWidgetItem *id = table->item(row, 0);
+        QTableWidgetItem *start = table->item(row, 1);
+        if (!id || !start)
+            continue;
+
+        const bool cached = eventCache.contains(currentPortName, quint16(id->text().toInt()), start->text());
+        table->setItem(row, 3, new QTableWidgetItem(cached ? "cached" : ""));
+    }
+}
+
+void MainWindow::on_pushButton_downloadEvents_clicked()
+{
+    if (batchTotal > 0)
+    {
+        QMessageBox::information(this, "Download Events", "A download is already running");
+        return;
+    }
+    if (!eventCache.isEnabled())
+    {
+        QMessageBox::warning(this, "Download Events", "The event cache is disabled ([EventCache] enabled in settings.ini)");
+        return;
+    }
+
+    // Selected rows, or every event of the Get Log Events table
+    QTableWidget *table = ui->tableWidget_getLogEvents;
+    QList<int> rows;
+    for (const QModelIndex &index : table->selectionModel()->selectedRows())
+        rows.append(index.row());
+    if (rows.isEmpty())
+    {
+        for (int row = 0; row < table->rowCount(); ++row)
+            rows.append(row);
+    }
+    std::sort(rows.begin(), rows.end());
+
+    if (rows.isEmpty())
+    {
+        QMessageBox::information(this, "Download Events", "No events listed, use Get Log Events first");
+        return;
+    }
+
+    // Events already in the cache are skipped, the rest go back to back through the command queue
+    QList<quint16> eventIds;
+    int alreadyCached = 0;
+    for (int row : rows)
+    {
+        QTableWidgetItem *id = table->item(row, 0);
+        QTableWidgetItem *start = table->item(row, 1);
+        if (!id)
+            continue;
+
+        const quint16 eventId = quint16(id->text().toInt());
+        if (eventCache.contains(currentPortName, eventId, start ? start->text() : QString()))
+            alreadyCached++;
+        else
+            eventIds.append(eventId);
+    }
+
+    writeToNotes(QString("Download Events: %1 to download, %2 already cached").arg(eventIds.size()).arg(alreadyCached));
+    if (eventIds.isEmpty())
+    {
+        QMessageBox::information(this, "Download Events", QString("All %1 events are already cached").arg(alreadyCached));
+        return;
+    }
+
+    batchTotal = eventIds.size();
+    batchDone = 0;
+    batchFailed = 0;
+    dlgPlot = createPleaseWaitDialog(QString("⌛ Downloading event 1 / %1 ...").arg(batchTotal));
 
+    for (quint16 eventId : eventIds)
+        requestEvent(eventId, false);
+}
+
+void MainWindow::eventDownloadFinished(bool ok)
+{
+    if (batchTotal == 0)
+        return;
+
+    batchDone++;
+    if (!ok)
+        batchFailed++;
+
+    // A timeout clears the queue, every remaining download reports back as cancelled
+    if (batchDone < batchTotal)
+        return;
+
+    if (dlgPlot)
+    {
+        dlgPlot->close();
+        dlgPlot = nullptr;
+    }
+
+    const QString summary = QString("%1 of %2 events downloaded to %3, %4 failed or damaged")
+            .arg(batchTotal - batchFailed).arg(batchTotal).arg(eventCache.directory()).arg(batchFailed);
+    writeToNotes("Download Events: " + summary);
+    batchTotal = 0;
+    markCachedEvents();
+
+    QMessageBox::information(this, "Download Events", summary);
 }
 
 void MainWindow::on_pushButton_startLog_clicked()
@@ -1737,9 +1761,6 @@ void MainWindow::on_pushButton_startLog_clicked()
         return;
     }
 
-
-    responseTimer->start(2000); // 2 Sec timer
-
     QByteArray command;
 
     initializeSensorVectors();
@@ -1752,17 +1773,12 @@ void MainWindow::on_pushButton_startLog_clicked()
     qDebug() << "Start Log cmd sent : " + hexBytes(command);
     writeToNotes("Start Log cmd sent : " + hexBytes(command));
 
-
-    emit sendMsgId(0x02);
-    serialObj->writeData(command);
+    sendCommand(0x02, command, "Start Log");
 
 }
 
 void MainWindow::on_pushButton_getLogEvents_clicked()
 {
-    // Start the timeout timer
-    responseTimer->start(2000); // 2 Sec timer
-
     QByteArray command;
 
     command.append(0x53); //1
@@ -1774,15 +1790,11 @@ void MainWindow::on_pushButton_getLogEvents_clicked()
     writeToNotes("Get Log Events cmd sent : " + hexBytes(command));
 
 
-    emit sendMsgId(0x03);
-    serialObj->writeData(command);
+    sendCommand(0x03, command, "Get Log Events");
 }
 
 void MainWindow::on_pushButton_stopPlot_clicked()
 {
-    // Start the timeout timer
-    //responseTimer->start(2000); // 2 Sec timer
-
     QByteArray command;
 
     command.append(0x53); //1
@@ -1869,6 +1881,11 @@ void MainWindow::on_pushButton_fitToScreen_clicked()
 
         if (hasData)
         {
+            // Decimated graphs only hold the visible window, go back to the whole event first
+            for (int i = 0; i < plot->graphCount(); ++i)
+                if (LodPlotBinder *lod = LodPlotBinder::find(plot->graph(i)))
+                    lod->showAll();
+
             //  Auto-fit to existing data
             plot->rescaleAxes(true);
 
@@ -1930,7 +1947,8 @@ void MainWindow::on_pushButton_saveLogPlots_clicked()
 
     // Write table data
     int rowCount = ui->tableWidget_getLogEvents->rowCount();
-    int colCount = ui->tableWidget_getLogEvents->columnCount();
+    // Only the device columns, the Local (cached) column is not part of the export
+    int colCount = qMin(3, ui->tableWidget_getLogEvents->columnCount());
 
     for (int r = 0; r < rowCount; ++r)
     {
@@ -1995,7 +2013,11 @@ void MainWindow::on_pushButton_clearPlots_clicked()
      {
          if (plot) {
              for (int i = 0; i < plot->graphCount(); ++i)
+             {
+                 // Detach the decimated series first, the next zoom would reload it otherwise
+                 delete LodPlotBinder::find(plot->graph(i));
                  plot->graph(i)->data()->clear();
+             }
              plot->replot();
          }
      }
@@ -2072,7 +2094,6 @@ void MainWindow::on_pushButton_clearPoints_fft_clicked()
 
 void MainWindow::on_pushButton_logTime_clicked()
 {
-    responseTimer->start(2000);
     if(ui->spinBox_logTime->value()>10||ui->spinBox_logTime->value()<1){
         QMessageBox::information(this,"out of Range","Enter the value between 1 and 10");
         return;
@@ -2083,15 +2104,13 @@ void MainWindow::on_pushButton_logTime_clicked()
     logTime.append(static_cast<char>(value));      // append value (1 byte)
     logTime.append(static_cast<char>(0xFF));
 
-    emit sendMsgId(0x10);
-    serialObj->writeData(logTime);
+    sendCommand(0x10, logTime, "Log Time");
 
 
 }
 
 void MainWindow::on_pushButton_setthreshold_clicked()
 {
-    responseTimer->start(2000);
     if(ui->spinBox_threshold->value()>200||ui->spinBox_threshold->value()<-200){
         QMessageBox::information(this,"out of Range","Enter the value between -200 and 200");
         return;
@@ -2106,15 +2125,13 @@ void MainWindow::on_pushButton_setthreshold_clicked()
     threshold.append(static_cast<char>(0xFF));
     qDebug()<<"value send"<<value;
 
-    emit sendMsgId(0x10);
-    serialObj->writeData(threshold);
+    sendCommand(0x10, threshold, "Threshold");
 
 
 }
 
 void MainWindow::on_pushButton_setTime_clicked()
 {
-    responseTimer->start(2000);
     QDateTime dt = ui->dateTimeEdit->dateTime();
 
     int year  = dt.date().year();
@@ -2136,16 +2153,11 @@ void MainWindow::on_pushButton_setTime_clicked()
     packet.append(static_cast<char>(second));
     packet.append(static_cast<char>(0xFF));
 
-    emit sendMsgId(0x10);
-    serialObj->writeData(packet);
-
-
-
+    sendCommand(0x10, packet, "Set Time");
 }
 
 void MainWindow::on_pushButton_ADXLfrequency_clicked()
 {
-    responseTimer->start(2000);
     if(ui->spinBox_samplingfrequency->value()>20000||ui->spinBox_samplingfrequency->value()<1){
         QMessageBox::information(this,"out of Range","Enter the value between 1 and 20000");
         return;
@@ -2156,12 +2168,10 @@ void MainWindow::on_pushButton_ADXLfrequency_clicked()
      packet.append(static_cast<char>(value & 0xFF));
      packet.append(static_cast<char>(0xFF));
      qDebug()<<"adxl sent"<<packet.toHex();
-     serialObj->writeData(packet);
-     emit sendMsgId(0x10);
+     sendCommand(0x10, packet, "ADXL Sampling Frequency");
 }
 void MainWindow::on_pushButton_inclinometerFrequency_clicked()
 {
-    responseTimer->start(2000);
   if(ui->spinBox_Inclinometer->value()>1000||ui->spinBox_Inclinometer->value()<1){
       QMessageBox::information(this,"out of Range","Enter the value between 1 and 1000");
       return;
@@ -2171,36 +2181,28 @@ void MainWindow::on_pushButton_inclinometerFrequency_clicked()
   packet.append(static_cast<char>((value >> 8) & 0xFF));
   packet.append(static_cast<char>(value & 0xFF));
   packet.append(static_cast<char>(0xFF));
-  serialObj->writeData(packet);
-  emit sendMsgId(0x10);
+  sendCommand(0x10, packet, "Inclinometer Frequency");
 
 }
 
 void MainWindow::on_pushButton_remainingLogs_clicked()
 {
-    responseTimer->start(2000);
     QByteArray packet=QByteArray::fromHex("535454");
-    serialObj->writeData(packet);
-     emit sendMsgId(0x05);
+    sendCommand(0x05, packet, "Remaining Logs");
 }
 void MainWindow::on_pushButton_currentParameters_clicked()
 {
-    responseTimer->start(2000);
     QByteArray packet=QByteArray::fromHex("535455");
-    serialObj->writeData(packet);
-     emit sendMsgId(0x06);
-
+    sendCommand(0x06, packet, "Current Parameters");
 }
 void MainWindow::on_pushButton_erase_clicked()
 {
-    responseTimer->start(2000);
     QByteArray eraseCmd=QByteArray::fromHex("535441");
     QMessageBox::StandardButton reply;
     reply = QMessageBox::question(this, "Confirm", "Do you want to Erase logs?",
                                   QMessageBox::Yes | QMessageBox::No);
     if (reply == QMessageBox::Yes) {
-    emit sendMsgId(0x07);
-    serialObj->writeData(eraseCmd);
+    sendCommand(0x07, eraseCmd, "Erase Logs");
     }
     else{
        QMessageBox::information(this,"Cancelled","User cancel the erase logs");
@@ -2208,21 +2210,14 @@ void MainWindow::on_pushButton_erase_clicked()
 }
 void MainWindow::on_pushButton_on_clicked()
 {
-    responseTimer->start(2000);
     QByteArray packet=QByteArray::fromHex("535447");
-    emit sendMsgId(0x08);
-    serialObj->writeData(packet);
-
-
+    sendCommand(0x08, packet, "Power On");
 }
 
 void MainWindow::on_pushButton_off_clicked()
 {
-    responseTimer->start(2000);
     QByteArray packet=QByteArray::fromHex("535448");
-    emit sendMsgId(0x09);
-
-    serialObj->writeData(packet);
+    sendCommand(0x09, packet, "Power Off");
 
 }
 
@@ -2238,119 +2233,22 @@ void MainWindow::blinkWidget(QWidget *w)
 }
 void MainWindow::removeDC(QVector<double> &x)
 {
-    if (x.isEmpty()) return;
-
-    double sum = 0;
-    for (double v : x) sum += v;
-    double mean = sum / x.size();
-
-    for (double &v : x) v -= mean;
+    SignalProcessing::removeDC(x);
 }
 
-
-
 void MainWindow::applyHanning(QVector<double> &signal)
 {
-    const int N = signal.size();
-
-    // --- Guard for invalid or trivial cases ---
-    if (N <= 1)
-    {
-        qWarning() << "applyHanning: signal too short (N =" << N << ")";
-        return;
-    }
-
-    // --- Precompute constant factor ---
-    const double coeff = 2.0 * M_PI / static_cast<double>(N - 1);
-
-    for (int n = 0; n < N; ++n)
-    {
-        const double w = 0.5 * (1.0 - std::cos(coeff * n));
-        signal[n] *= w;
-    }
+    SignalProcessing::applyHanning(signal);
 }
 
-
 void MainWindow::performFFT(const QVector<double> &input,
                             QVector<double> &magnitude,
                             QVector<double> &freqAxis,
                             double sampleRate)
 {
-    int N = input.size();
-
-    if (N <= 1)
-    {
-        qWarning() << "performFFT: invalid N =" << N;
-        return;
-    }
-
-    // --- Ensure power-of-two size ---
-    if ((N & (N - 1)) != 0)
-    {
-        int nextPow2 = pow(2, ceil(log2(N)));
-        qWarning() << "performFFT: non power-of-two size" << N << "-> padded to" << nextPow2;
-
-        QVector<double> padded = input;
-        padded.resize(nextPow2);
-        for (int i = N; i < nextPow2; ++i)
-            padded[i] = 0;
-
-        // recurse safely
-        performFFT(padded, magnitude, freqAxis, sampleRate);
-        return;
-    }
-
-    // --- Prepare input ---
-    std::vector<kiss_fft_cpx> timeData(N), freqData(N);
-    for (int i = 0; i < N; ++i)
-    {
-        timeData[i].r = input[i];
-        timeData[i].i = 0.0;
-    }
-
-    // --- Allocate FFT plan ---
-    kiss_fft_cfg cfg = kiss_fft_alloc(N, 0, nullptr, nullptr);
-    if (!cfg)
-    {
-        qCritical() << "performFFT: kiss_fft_alloc failed for N =" << N;
-        return;
-    }
-
-    qDebug() << "Debug 9: performing FFT of size" << N;
-
-    // --- Execute safely ---
-    kiss_fft(cfg, timeData.data(), freqData.data());
-
-    qDebug() << "Debug 10: FFT complete";
-
-#ifdef kiss_fft_free
-    kiss_fft_free(cfg);
-#else
-    free(cfg);
-#endif
-
-    // --- Prepare output ---
-    int half = N / 2;
-    magnitude.resize(half + 1);
-    freqAxis.resize(half + 1);
-
-    const double windowGain = 0.5;
-
-    for (int k = 0; k <= half; ++k)
-    {
-        double re = freqData[k].r;
-        double im = freqData[k].i;
-        double mag = sqrt(re * re + im * im);
-
-        magnitude[k] = ((k == 0 || k == half) ? (mag / N) : ((2.0 * mag) / N)) / windowGain;
-        freqAxis[k] = (sampleRate * k) / N;
-    }
+    SignalProcessing::performFFT(input, magnitude, freqAxis, sampleRate);
 }
 
-
-
-
-
 void MainWindow::computeAndPlotFFT(const QVector<double>& signal,
                                    double Fs,
                                    QCustomPlot *plot)
@@ -2358,20 +2256,25 @@ void MainWindow::computeAndPlotFFT(const QVector<double>& signal,
     if (signal.isEmpty() || plot == nullptr)
         return;
 
+    SignalProcessing::Spectrum spectrum;
     QVector<double> processed = signal;
-    qDebug()<<"Debug 3";
     applyHanning(processed);   // 2. apply window
+    performFFT(processed, spectrum.magnitude, spectrum.freqAxis, Fs);  // 3. FFT
 
-    qDebug()<<"Debug 4";
-    QVector<double> mag, freq;
+    plotSpectrum(spectrum, Fs, plot);
+}
 
-    qDebug()<<"Debug 5";
-    performFFT(processed, mag, freq, Fs);  // 3. FFT
+void MainWindow::plotSpectrum(const SignalProcessing::Spectrum &spectrum,
+                              double Fs,
+                              QCustomPlot *plot)
+{
+    if (plot == nullptr || spectrum.magnitude.isEmpty())
+        return;
 
     // ---- Plot (correct way) ----
     if (plot->graphCount() > 0)
     {
-        plot->graph(0)->setData(freq, mag);
+        plot->graph(0)->setData(spectrum.freqAxis, spectrum.magnitude);
 
         plot->xAxis->setRange(0, Fs/2);   // do NOT auto-rescale X
         plot->yAxis->rescale();           // only Y auto-scale
@@ -2444,6 +2347,9 @@ void MainWindow::dataProcessing(const QByteArray &byteArrayData)
         }
         setupPlot(ui->customPlot_incl_x_live,QString("Inclinometer X&Y Time(1 = %1)").arg(displayInclinometerfreq),"Degrees(°)",1);
 
+        // Strip chart windows follow the live rates
+        configureLiveStrips();
+
     }
 
     else if(data.startsWith(QByteArray::fromHex("CC DD FF"))&&data.endsWith(QByteArray::fromHex("EE FF")))
@@ -2455,7 +2361,10 @@ void MainWindow::dataProcessing(const QByteArray &byteArrayData)
             if (packet4100.endsWith(QByteArray::fromHex("EE FF")))
             {
                 packet4100.remove(packet4100.size()-62,60);
-                if(packet4100.contains(QByteArray::fromHex("FF FF FF FF FF FF")))
+
+                // One pass for the padding position and the packet's FF statistics
+                const PaddingScanner::ScanResult scan = PaddingScanner::scan(packet4100.constData(), packet4100.size());
+                if(scan.padded())
                 {
                     // Special condition FF's checking
                     QByteArray specialPacket = packet4100;
@@ -2463,8 +2372,9 @@ void MainWindow::dataProcessing(const QByteArray &byteArrayData)
                     qDebug()<<"Consecutive FF's detected at packet [ADXL]: "+QString::number(packet4100Adxl.size());
                     writeToNotes("Consecutive FF's detected at packet [ADXL]: " + QString::number(packet4100Adxl.size()));
 
-                    int fIndex = specialPacket.indexOf(QByteArray::fromHex("FF FF FF FF FF FF"));
+                    int fIndex = scan.firstRun;
                     qDebug()<<fIndex<<" :fIndex";
+                    recordLivePadding(scan, (specialPacket.size() - fIndex) - 5);
 
                     qDebug()<< "Removing ff bytes count [ADXL]: " << (specialPacket.size() - fIndex) - 5;
                     writeToNotes("Removing ff bytes count [ADXL]: " + QString::number((specialPacket.size() - fIndex) - 5));
@@ -2477,12 +2387,14 @@ void MainWindow::dataProcessing(const QByteArray &byteArrayData)
 
                     // writeToNotes Log
                     writeToNotes("fIndex (start of FFs) [ADXL]: " + QString::number(fIndex));
-                    writeToNotes("specialPacket [ADXL]: " + specialPacket.toHex(' ').toUpper());
+                    if (AsyncLogger::instance().isEnabled(LogLevel::Trace))
+                        AsyncLogger::instance().log(LogLevel::Trace, "specialPacket [ADXL]: " + specialPacket.toHex(' ').toUpper());
                 }
                 else
                 {
                     // Normal condition
                     packet4100Adxl.append(packet4100);
+                    recordLivePadding(scan);
                 }
 
                 // Extract last 2 bytes before footer as temperature
@@ -2512,7 +2424,8 @@ void MainWindow::dataProcessing(const QByteArray &byteArrayData)
                 {
                      packet4100.remove(packet4100.size()-62,60);
 
-                    if(packet4100.contains(QByteArray::fromHex("FF FF FF FF FF FF")))
+                    const PaddingScanner::ScanResult scan = PaddingScanner::scan(packet4100.constData(), packet4100.size());
+                    if(scan.padded())
                     {
                         // Special condition FF's checking
                         QByteArray specialPacket = packet4100;
@@ -2521,8 +2434,9 @@ void MainWindow::dataProcessing(const QByteArray &byteArrayData)
                         writeToNotes("Consecutive FF's detected at packet [INCLINOMETER]: " + QString::number(packet4100Incl.size()));
 
 
-                        int fIndex = specialPacket.indexOf(QByteArray::fromHex("FF FF FF FF FF FF"));
+                        int fIndex = scan.firstRun;
                         qDebug()<<fIndex<<" :fIndex";
+                        recordLivePadding(scan, (specialPacket.size() - fIndex) - 5);
 
                         qDebug()<< "Removing ff bytes count [INCLINOMETER]: " << (specialPacket.size() - fIndex) - 5;
                         writeToNotes("Removing ff bytes count [INCLINOMETER]: " + QString::number((specialPacket.size() - fIndex) - 5));
@@ -2535,12 +2449,14 @@ void MainWindow::dataProcessing(const QByteArray &byteArrayData)
 
                         // writeToNotes Log
                         writeToNotes("fIndex (start of FFs) [INCLINOMETER]: " + QString::number(fIndex));
-                        writeToNotes("specialPacket [INCLINOMETER]: " + specialPacket.toHex(' ').toUpper());
+                        if (AsyncLogger::instance().isEnabled(LogLevel::Trace))
+                            AsyncLogger::instance().log(LogLevel::Trace, "specialPacket [INCLINOMETER]: " + specialPacket.toHex(' ').toUpper());
                     }
                     else
                     {
                         // Normal condition
                         packet4100Incl.append(packet4100);
+                        recordLivePadding(scan);
                     }
                 }
                 else
@@ -2569,58 +2485,12 @@ quint64 getCurrentProcessMemoryMB()
 
 void MainWindow::makePacket4100AdxlLive(const QByteArray &rawPacket4100Adxl)
 {
-    QVector<double> sampleIndex;
     QVector<double> xAdxl, yAdxl, zAdxl;
-    int globalSample = 0;
     qDebug()<<"Extracting bytes";
 
     // --- ADXL Data Processing ---
-
-        QByteArray packet = rawPacket4100Adxl;
-
-        if (packet.size() < 20)
-        {
-            qDebug() << "Skipping too short ADXL packet:" << packet.size();
-            return;
-        }
-
-        QByteArray trimmed = packet.mid(3);
-        if (trimmed.size() > 3) trimmed.chop(3); // remove footer
-        if (trimmed.size() > 2) trimmed.chop(2); // remove temperature bytes
-
-        int usableSize = trimmed.size();
-        if (usableSize < 6)
-        {
-            qDebug() << "Packet too short after trimming:" << usableSize;
-            return;
-        }
-
-        for (int i = 0; i + 5 < usableSize; i += 6)
-        {
-            qint16 xRaw = (static_cast<quint8>(trimmed[i])     << 8) | static_cast<quint8>(trimmed[i + 1]);
-            qint16 yRaw = (static_cast<quint8>(trimmed[i + 2]) << 8) | static_cast<quint8>(trimmed[i + 3]);
-            qint16 zRaw = (static_cast<quint8>(trimmed[i + 4]) << 8) | static_cast<quint8>(trimmed[i + 5]);
-
-            // Keep last 12 bits only first 4 bits eliminate in a 16 bit integer
-            xRaw &= 0x0FFF;
-            yRaw &= 0x0FFF;
-            zRaw &= 0x0FFF;
-
-            sampleIndex.append(globalSample++);
-            xAdxl.append((xRaw * 3.3 * 2) / 4096.0);
-            yAdxl.append((yRaw * 3.3 * 2) / 4096.0);
-            zAdxl.append((zRaw * 3.3 * 2) / 4096.0);
-        }
-    for(int g=0;g<xAdxl.size();g++){
-        xAdxl[g]=(xAdxl[g]-1.65)/0.0063;
-        yAdxl[g]=(yAdxl[g]-1.65)/0.0063;
-        zAdxl[g]=(zAdxl[g]-1.65)/0.0063;
-
-    }
-    if (adxlWindow < 0) {
-        adxlWindow = sampleIndex.size();
-        qDebug() << "Fixed X-axis window set =" << adxlWindow;
-    }
+    if (PacketDecoder::decodeAdxlPacket(rawPacket4100Adxl, xAdxl, yAdxl, zAdxl) == 0)
+        return;
 
 //    quint64 memMB = getCurrentProcessMemoryMB();
 //    qDebug()<<memMB<<"memory used";
@@ -2640,99 +2510,130 @@ void MainWindow::makePacket4100AdxlLive(const QByteArray &rawPacket4100Adxl)
 //        pending_yAdxl += yAdxl;
 //        pending_zAdxl += zAdxl;
 
-        // optionally keep full history for later export
-        if(saveLive){
-        full_xAdxl += xAdxl;
-        full_yAdxl += yAdxl;
-        full_zAdxl += zAdxl;
-         }
+        // Save Live: handed to the capture writer, flushed to disk every few seconds
+        liveWriter.appendAdxl(xAdxl, yAdxl, zAdxl);
 
-        if (!ui->checkBox_fft->isChecked())
-        {
-            // time-domain
-            livePlot(ui->customPlot_adxl_x_live, sampleIndex, xAdxl,adxlWindow,0);
-            livePlot(ui->customPlot_adxl_y_live, sampleIndex, yAdxl,adxlWindow,0);
-            livePlot(ui->customPlot_adxl_z_live, sampleIndex, zAdxl,adxlWindow,0);
-        }
-        else
+        // time-domain history, drawn by refreshLivePlots()
+        adxlStrip[0].append(xAdxl);
+        adxlStrip[1].append(yAdxl);
+        adxlStrip[2].append(zAdxl);
+
+        if (ui->checkBox_fft->isChecked())
         {
             plotLiveFFT(xAdxl, adxlFreqL, ui->customPlot_adxl_x_live);
             plotLiveFFT(yAdxl, adxlFreqL, ui->customPlot_adxl_y_live);
             plotLiveFFT(zAdxl,adxlFreqL, ui->customPlot_adxl_z_live);
         }
 
-    qDebug() << "Total ADXL samples:" << sampleIndex.size();
+    qDebug() << "Total ADXL samples:" << xAdxl.size();
 }
 void MainWindow::makePacket4100InclLive(const QByteArray &rawPacket4100Incl)
 {
-    QByteArray packet = rawPacket4100Incl;
     QVector<double> inclXL, inclYL;
-    QVector<double> sampleIndex;
-    int index=0;
 
-    if (packet.size() < 20)
-    {
-        qDebug() << "Skipping too short inclinometer packet:" << packet.size();
+    if (PacketDecoder::decodeInclPacket(rawPacket4100Incl, inclXL, inclYL) == 0)
         return;
-    }
-
-    // Remove header (3 bytes)
-    QByteArray trimmed = packet.mid(3);
-
-    // Remove footer (3 bytes)
-    if (trimmed.size() > 3)
-        trimmed.chop(3);
 
-    // Remove last 2 dummy bytes before footer
-    if (trimmed.size() > 2)
-        trimmed.chop(2);
-
-    int usableSize = trimmed.size();
-    if (usableSize < 4)
-    {
-        qDebug() << "Packet too short after trimming:" << usableSize;
-        return;
-    }
+    liveWriter.appendIncl(inclXL, inclYL);
 
+    inclStrip[0].append(inclXL);
+    inclStrip[1].append(inclYL);
+}
 
+void MainWindow::recordLivePadding(const PaddingScanner::ScanResult &scan, int removedBytes)
+{
+    livePadding.add(scan, removedBytes);
+    devicePadding[currentPortName].add(scan, removedBytes);
+}
 
-    // Process each 4-byte sample (Xg, Yg)
-    for (int i = 0; i + 3 < usableSize; i += 4)
-    {
-        qint16 xRaw = (static_cast<quint8>(trimmed[i + 1])     << 8) | static_cast<quint8>(trimmed[i]);
-        qint16 yRaw = (static_cast<quint8>(trimmed[i + 3]) << 8) | static_cast<quint8>(trimmed[i + 2]);
+void MainWindow::logPaddingStats(const QString &source, const PaddingScanner::Counters &counters)
+{
+    const QString device = currentPortName.isEmpty() ? "unknown port" : currentPortName;
+    const PaddingScanner::Counters &total = devicePadding.value(currentPortName);
 
-        // Convert to g-values
-        double xg = (xRaw * 0.031) / 1000.0;
-        double yg = (yRaw * 0.031) / 1000.0;
+    const QString line = QString("Flash padding %1 [%2]: %3 / %4 packets padded, %5 FF bytes removed, longest FF run %6"
+                                 " | device total %7 / %8 packets (%9 %)")
+            .arg(source, device)
+            .arg(counters.paddedPackets).arg(counters.packets)
+            .arg(counters.removedBytes).arg(counters.longestRun)
+            .arg(total.paddedPackets).arg(total.packets)
+            .arg(total.paddedPercent(), 0, 'f', 2);
+    qDebug() << line;
+    writeToNotes(line);
+}
 
+void MainWindow::configureLiveStrips()
+{
+    // Window length in seconds, converted with the live rates (sample index axis, "1 = 1/freq")
+    QSettings settings("settings.ini", QSettings::IniFormat);
+    const double windowSeconds = settings.value("LivePlot/windowSeconds", 10).toDouble();
+    const int historyBuckets = settings.value("LivePlot/historyBuckets", StripChart::DEFAULT_HISTORY_BUCKETS).toInt();
 
-        // Clamp to [-1, 1]
-        xg = std::max(-1.0, std::min(1.0, xg));
-        yg = std::max(-1.0, std::min(1.0, yg));
+    const int adxlRate = adxlFreqL > 0 ? adxlFreqL : LIVE_FALLBACK_RATE;
+    const int inclRate = inclFreqL > 0 ? inclFreqL : LIVE_FALLBACK_RATE;
 
-        // Convert to degrees
-        double xDeg = std::asin(xg) * (180.0 / M_PI);
-        double yDeg = std::asin(yg) * (180.0 / M_PI);
+    for (StripChart &strip : adxlStrip)
+        strip.configure(qMax(1, int(windowSeconds * adxlRate)), historyBuckets);
+    for (StripChart &strip : inclStrip)
+        strip.configure(qMax(1, int(windowSeconds * inclRate)), historyBuckets);
 
-        sampleIndex.append(index++);
-        inclXL.append(xDeg);
-        inclYL.append(yDeg);
+    qDebug() << "Live window" << windowSeconds << "s:" << adxlStrip[0].windowSamples() << "ADXL samples,"
+             << inclStrip[0].windowSamples() << "inclinometer samples";
+}
 
+void MainWindow::refreshLivePlots()
+{
+    auto fitValueAxis = [](QCustomPlot *plot, const QCPRange &range)
+    {
+        if (range.size() > 0)
+        {
+            plot->yAxis->setRange(range);
+            plot->yAxis->scaleRange(1.05, range.center());
+        }
+        else
+        {
+            plot->yAxis->setRange(range.lower - 1, range.upper + 1);
+        }
+    };
 
-        if(inclWindow<0)
+    // ---- ADXL (the FFT view is drawn per packet by plotLiveFFT) ----
+    if (!ui->checkBox_fft->isChecked())
+    {
+        QCustomPlot *adxlPlots[3] = { ui->customPlot_adxl_x_live, ui->customPlot_adxl_y_live, ui->customPlot_adxl_z_live };
+        for (int i = 0; i < 3; ++i)
         {
-         inclWindow=sampleIndex.size();
+            if (!adxlStrip[i].isDirty())
+                continue;
+            if (adxlPlots[i]->graphCount() == 0)
+                adxlPlots[i]->addGraph();
+
+            bool found = false;
+            QCPRange range = adxlStrip[i].render(adxlPlots[i]->graph(0), found);
+            if (found)
+                fitValueAxis(adxlPlots[i], range);
+            adxlPlots[i]->replot();
         }
     }
-    if(saveLive)
-    {
-    fullInclXL+=inclXL;
-    fullInclYL+=inclYL;
-     }
 
-    livePlot(ui->customPlot_incl_x_live, sampleIndex, inclXL,inclWindow,0);
-    livePlot(ui->customPlot_incl_x_live, sampleIndex, inclYL,inclWindow,1);
+    // ---- Inclinometer X & Y share one plot ----
+    if (inclStrip[0].isDirty() || inclStrip[1].isDirty())
+    {
+        QCustomPlot *plot = ui->customPlot_incl_x_live;
+        while (plot->graphCount() < 2)
+            plot->addGraph();
+
+        bool foundX = false, foundY = false;
+        QCPRange range = inclStrip[0].render(plot->graph(0), foundX);
+        QCPRange rangeY = inclStrip[1].render(plot->graph(1), foundY);
+        if (foundX && foundY)
+            range.expand(rangeY);
+        else if (foundY)
+            range = rangeY;
+
+        if (foundX || foundY)
+            fitValueAxis(plot, range);
+        plot->replot();
+    }
 }
 //void MainWindow::onUiUpdateTimer()
 //{
@@ -2756,30 +2657,6 @@ void MainWindow::makePacket4100InclLive(const QByteArray &rawPacket4100Incl)
     // Now update plots on GUI thread (one batch per timer tick)
 
 //}
-void MainWindow::livePlot(QCustomPlot *plot,
-                          const QVector<double> &xValues,
-                          const QVector<double> &yValues,
-                          int Window,
-                          int graphIndex)
-{
-    if (!plot) return;
-    if (xValues.isEmpty() || yValues.isEmpty()) return;
-    if (xValues.size() != yValues.size()) return;
-
-    // If graphIndex is out of range → create graph
-    if (graphIndex >= plot->graphCount())
-        plot->addGraph();
-
-    plot->graph(graphIndex)->data()->clear();
-    plot->graph(graphIndex)->addData(xValues, yValues);
-
-    if (Window > 0)
-        plot->xAxis->setRange(xValues.last() - Window, xValues.last());
-
-    plot->graph(graphIndex)->rescaleValueAxis(true);
-    plot->replot();
-}
-
 void MainWindow::plotLiveFFT(const QVector<double>& signal,
                              double Fs,
                              QCustomPlot *plot)
@@ -2882,8 +2759,13 @@ void MainWindow::on_checkBox_livePlot_stateChanged(int arg1)
 {
     Q_UNUSED(arg1);
     if (!ui->checkBox_livePlot->isChecked()) {
-        QByteArray livePlotUnCheck=QByteArray::fromHex("53 54 57");
-        serialObj->writeData(livePlotUnCheck);
+        // No response, written at once even with a command on the link (the live stream has to stop now)
+        CommandScheduler::Request request;
+        request.bytes = QByteArray::fromHex("53 54 57");
+        request.label = "Live Plot Off";
+        request.expectsResponse = false;
+        request.immediate = true;
+        scheduler->submit(request);
         writeToNotes("live checkbox unchecked");
          ui->tabWidget->tabBar()->setEnabled(true);
 
@@ -2891,9 +2773,8 @@ void MainWindow::on_checkBox_livePlot_stateChanged(int arg1)
     else
     {
         QByteArray livePlotCheck=QByteArray::fromHex("53 54 56");
-         serialObj->writeData(livePlotCheck);
          writeToNotes("live checkbox checked");
-         emit sendMsgId(0x12);
+         sendCommand(0x12, livePlotCheck, "Live Plot On");
     }
 
 }
@@ -2902,69 +2783,122 @@ void MainWindow::on_pushButton_stopLivePlot_clicked()
 {
 
     ui->tabWidget->tabBar()->setEnabled(true);
-    responseTimer->start(2000);
 
     QByteArray stopPlot = QByteArray::fromHex("535458");  
     writeToNotes("stop command send:"+stopPlot.toHex(' ').toUpper());
 
 
-    emit sendMsgId(0x11);
-    serialObj->writeData(stopPlot);
+    // Frames still arriving before the stop acknowledge are parsed as live frames under 0x11 (receive buffer
+    // kept), the capture files are closed once the device confirmed the stop (or the command timed out /
+    // was cancelled)
+    CommandScheduler::Request request;
+    request.msgId = 0x11;
+    request.bytes = stopPlot;
+    request.label = "Live Plot Stop";
+    request.keepReceive = true;
+    scheduler->submit(request, [this](const CommandScheduler::Result &) {
+        // End of the acquisition, the next one starts its own padding summary
+        logPaddingStats("Live", livePadding);
+        livePadding = PaddingScanner::Counters();
+        finishLiveCapture();
+    });
+}
 
-    if (saveLimitTimer->isActive()) {
-            saveLimitTimer->stop();
-            qDebug() << "Timer stopped.";
-        }
+void MainWindow::finishLiveCapture()
+{
+    if (!liveWriter.isOpen())
+        return;
 
-     saveLive=false;
+    liveWriter.close();
 
-     QTimer::singleShot(50, this, [this]() {
-         if (!full_xAdxl.isEmpty() &&
-             !full_yAdxl.isEmpty() &&
-             !full_zAdxl.isEmpty() &&
-             !fullInclXL.isEmpty() &&
-             !fullInclYL.isEmpty())
-         {
-             saveLiveData(full_xAdxl, full_yAdxl, full_zAdxl,
-                          fullInclXL, fullInclYL);
-         }
-         else
-         {
-             QMessageBox::warning(this, "No Data", "No data to save");
-         }
-     });
+    const QString adxlFile = liveWriter.adxlFileName();
+    const QString inclFile = liveWriter.inclFileName();
+
+    if (liveWriter.adxlSamples() == 0 && liveWriter.inclSamples() == 0)
+    {
+        QFile::remove(adxlFile);
+        QFile::remove(inclFile);
+        QMessageBox::warning(this, "No Data", "No data to save");
+        return;
+    }
+
+    if (liveWriter.hasError())
+    {
+        QMessageBox::critical(this, "Failed", "Writing the live capture failed, data saved so far is in:\n"
+                              + adxlFile + "\n" + inclFile);
+        return;
+    }
+
+    // ---------------- CSV: the capture files are the result ----------------
+    if (liveTargetFormat == SampleExport::Format::Csv)
+    {
+        QMessageBox::information(this, "Success", "Saved successfully:\n" + adxlFile + "\n" + inclFile);
+        return;
+    }
+
+    // ---------------- XLSX / PARQUET: converted from the capture files once ----------------
+    QVector<QVector<double>> adxl, incl;
+    if (!LiveCaptureWriter::readColumns(adxlFile, 3, adxl) || !LiveCaptureWriter::readColumns(inclFile, 2, incl))
+    {
+        QMessageBox::critical(this, "Failed", "Unable to read the live capture back from:\n"
+                              + adxlFile + "\n" + inclFile);
+        return;
+    }
+
+    // Converted file written, the CSV capture files were only the spool
+    if (saveLiveData(liveTargetPath, liveTargetFormat, adxl[0], adxl[1], adxl[2], incl[0], incl[1]))
+    {
+        QFile::remove(adxlFile);
+        QFile::remove(inclFile);
+    }
 }
 
-void MainWindow::saveLiveData(const QVector<double> &xAdxl,
+bool MainWindow::saveLiveData(const QString &fullPath,
+                              SampleExport::Format format,
+                              const QVector<double> &xAdxl,
                               const QVector<double> &yAdxl,
                               const QVector<double> &zAdxl,
                               const QVector<double> &inclX,
                               const QVector<double> &inclY)
 {
-    // ---------------- SIMPLE FILE DIALOG FIRST ----------------
-    QString defaultName = QString("SensorLiveData_%1.xlsx")
-            .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
-
-    QString desktopPath = QStandardPaths::writableLocation(QStandardPaths::DesktopLocation);
+    QDialog* waitDlg = createPleaseWaitDialog("Data Saving... Please wait");
 
-    QString fullPath = QFileDialog::getSaveFileName(
-                this,
-                "Save Live Data",
-                desktopPath + "/" + defaultName,
-                "Excel Files (*.xlsx)"
-    );
+    // ---------------- CSV / PARQUET (streamed from the vectors, no workbook) ----------------
+    if (format != SampleExport::Format::Xlsx)
+    {
+        QVector<double> sampleIndex(std::max(xAdxl.size(), inclX.size()));
+        std::iota(sampleIndex.begin(), sampleIndex.end(), 0.0);
+
+        QVector<SampleExport::Column> columns;
+        columns << SampleExport::Column("Samples", sampleIndex.constData(), xAdxl.size())
+                << SampleExport::Column("ADXL X (g)", xAdxl)
+                << SampleExport::Column("ADXL Y (g)", yAdxl)
+                << SampleExport::Column("ADXL Z (g)", zAdxl)
+                << SampleExport::Column("Incl Index", sampleIndex.constData(), inclX.size())
+                << SampleExport::Column("Incl X (deg)", inclX)
+                << SampleExport::Column("Incl Y (deg)", inclY);
+
+        SampleExport::Metadata metadata;
+        metadata << qMakePair(QString("ADXL freq"), QString::number(adxlFreqL))
+                 << qMakePair(QString("Inclinometer freq"), QString::number(inclFreqL));
+
+        QString error;
+        bool ok = (format == SampleExport::Format::Csv)
+                ? SampleExport::writeCsv(fullPath, columns, metadata, &error)
+                : SampleExport::writeParquet(fullPath, columns, metadata, &error);
+
+        if(waitDlg)
+        {
+        waitDlg->close();
+        waitDlg=nullptr;
+        }
 
-    if (fullPath.isEmpty()) {
-        QMessageBox::information(this, "Save Cancelled",
-                                 "User cancelled the file save operation.");
-        return;
+        if (ok)
+            QMessageBox::information(this, "Success", "Saved successfully:\n" + fullPath);
+        else
+            QMessageBox::critical(this, "Failed", "Unable to save " + fullPath + "\n" + error);
+        return ok;
     }
-    if (!fullPath.endsWith(".xlsx", Qt::CaseInsensitive))
-        fullPath += ".xlsx";
-
-     qDebug()<<"dilaog created";
-    // 😊 NOW show your "Please Wait" dialog after choosing folder
-    QDialog* waitDlg = createPleaseWaitDialog("Data Saving... Please wait");
 
    qDebug()<<"saving started";
     // ---------------- CREATE XLSX ----------------
@@ -3012,14 +2946,19 @@ void MainWindow::saveLiveData(const QVector<double> &xAdxl,
     QXlsx::Format dataFormat;
     dataFormat.setBorderStyle(QXlsx::Format::BorderThin);
 
-    int row = 5;
-    int iRow = 5;
+    const int firstDataRow = 5;
+    const int rowsPerSheet = MAX_EXCEL_ROWS - 2 * firstDataRow + 1;   // rows 5 .. MAX_EXCEL_ROWS - 5
 
     int maxCount = std::max(xAdxl.size(), inclX.size());
 
-    for (int i = 0; i < maxCount; i++)
+    // Sample index column shared by ADXL and inclinometer
+    QVector<double> sampleIndex(maxCount);
+    std::iota(sampleIndex.begin(), sampleIndex.end(), 0.0);
+
+    // One block of columns per sheet, each column written in one call
+    for (int start = 0; start < maxCount; start += rowsPerSheet)
     {
-        if (row > MAX_EXCEL_ROWS - 5)
+        if (start > 0)
         {
             sheetNumber++;
             QString sheetName = QString("Sheet%1").arg(sheetNumber);
@@ -3027,23 +2966,21 @@ void MainWindow::saveLiveData(const QVector<double> &xAdxl,
             xlsx.selectSheet(sheetName);
 
             setupSheetHeader(xlsx);
-
-            row = 5;
-            iRow = 5;
         }
 
-        if (i < xAdxl.size()) {
-            xlsx.write(row, 1, i, dataFormat);
-            xlsx.write(row, 2, xAdxl[i], dataFormat);
-            xlsx.write(row, 3, yAdxl[i], dataFormat);
-            xlsx.write(row, 4, zAdxl[i], dataFormat);
-            row++;
+        const int adxlCount = qBound(0, xAdxl.size() - start, rowsPerSheet);
+        if (adxlCount > 0) {
+            xlsx.writeColumn(firstDataRow, 1, sampleIndex.constData() + start, adxlCount, dataFormat);
+            xlsx.writeColumn(firstDataRow, 2, xAdxl.constData() + start, adxlCount, dataFormat);
+            xlsx.writeColumn(firstDataRow, 3, yAdxl.constData() + start, adxlCount, dataFormat);
+            xlsx.writeColumn(firstDataRow, 4, zAdxl.constData() + start, adxlCount, dataFormat);
         }
-        if (i < inclX.size()) {
-            xlsx.write(iRow, 6, i, dataFormat);
-            xlsx.write(iRow, 7, inclX[i], dataFormat);
-            xlsx.write(iRow, 8, inclY[i], dataFormat);
-            iRow++;
+
+        const int inclCount = qBound(0, inclX.size() - start, rowsPerSheet);
+        if (inclCount > 0) {
+            xlsx.writeColumn(firstDataRow, 6, sampleIndex.constData() + start, inclCount, dataFormat);
+            xlsx.writeColumn(firstDataRow, 7, inclX.constData() + start, inclCount, dataFormat);
+            xlsx.writeColumn(firstDataRow, 8, inclY.constData() + start, inclCount, dataFormat);
         }
     }
 
@@ -3058,32 +2995,72 @@ void MainWindow::saveLiveData(const QVector<double> &xAdxl,
         QMessageBox::information(this, "Success", "Saved successfully:\n" + fullPath);
     else
         QMessageBox::critical(this, "Failed", "Unable to save Excel file.");
+    return ok;
 }
 
 
 void MainWindow::on_pushButton_saveLive_clicked()
 {
+    if (liveWriter.isOpen()) {
+        QMessageBox::information(this, "Save Live", "Live data is already being saved to:\n"
+                                 + liveWriter.adxlFileName() + "\n" + liveWriter.inclFileName());
+        return;
+    }
 
-        saveLive = true;
-        if (!saveLimitTimer->isActive()) {
-            saveLimitTimer->start(480000);
-            qDebug() << "Timer started.";
-        } else {
-            qDebug() << "Timer already running. Not restarting.";
-        }
+    // ---------------- FILE DIALOG BEFORE CAPTURE STARTS ----------------
+    QString defaultName = QString("SensorLiveData_%1.csv")
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
 
+    QString desktopPath = QStandardPaths::writableLocation(QStandardPaths::DesktopLocation);
 
+    QString selectedFilter;
+    QString fullPath = QFileDialog::getSaveFileName(
+                this,
+                "Save Live Data",
+                desktopPath + "/" + defaultName,
+                "CSV Files (*.csv);;Excel Files (*.xlsx);;Parquet Files (*.parquet)",
+                &selectedFilter
+    );
+
+    if (fullPath.isEmpty()) {
+        QMessageBox::information(this, "Save Cancelled",
+                                 "User cancelled the file save operation.");
+        return;
+    }
+
+    liveTargetFormat = SampleExport::formatFor(fullPath, selectedFilter);
+    if (!fullPath.endsWith(SampleExport::suffix(liveTargetFormat), Qt::CaseInsensitive))
+        fullPath += SampleExport::suffix(liveTargetFormat);
+    liveTargetPath = fullPath;
+
+    // Samples always go to <name>_adxl.csv / <name>_incl.csv while capturing,
+    // XLSX / Parquet are produced from them when the capture is stopped
+    QFileInfo info(fullPath);
+    const QString basePath = info.absolutePath() + "/" + info.completeBaseName();
+
+    SampleExport::Metadata metadata;
+    metadata << qMakePair(QString("ADXL freq"), QString::number(adxlFreqL))
+             << qMakePair(QString("Inclinometer freq"), QString::number(inclFreqL))
+             << qMakePair(QString("StartTime"), QDateTime::currentDateTime().toString(Qt::ISODate));
+
+    QString error;
+    if (!liveWriter.open(basePath, metadata, &error)) {
+        QMessageBox::critical(this, "Failed", "Unable to create live capture files:\n" + error);
+        return;
+    }
+
+    writeToNotes("Live capture saving to " + liveWriter.adxlFileName() + " / " + liveWriter.inclFileName());
 }
+
 void MainWindow::on_pushButton_startLive_clicked()
 {
      maxPeak_x = 0.0;
      maxPeak_y = 0.0;
      maxPeak_z = 0.0;
 
-    responseTimer->start(2000);
-
     QByteArray command;
     initializeSensorVectors();
+    configureLiveStrips();
 
     command.append(0x53);
     command.append(0x54);
@@ -3091,8 +3068,7 @@ void MainWindow::on_pushButton_startLive_clicked()
 
     qDebug() << "Start Log cmd sent : " + hexBytes(command);
     writeToNotes("Start Log cmd sent in livePlot: " + hexBytes(command));
-    emit sendMsgId(0x02);
-    serialObj->writeData(command);
+    sendCommand(0x02, command, "Start Log (live)");
 }
 
 void MainWindow::on_pushButton_fitToScreenLive_clicked()
@@ -18,10 +18,20 @@
 #include <QFutureWatcher>
 #include <QtConcurrent/QtConcurrent>
 #include <QLabel>
+#include <QMap>
+#include <QQueue>
 #include <QScreen>
 #include <QInputDialog>
 
 #include <enlargeplot.h>
+#include "asynclogger.h"
+#include "commandscheduler.h"
+#include "eventcache.h"
+#include "livecapturewriter.h"
+#include "paddingscanner.h"
+#include "sampleexport.h"
+#include "signalprocessing.h"
+#include "stripchart.h"
 #include "xlsxdocument.h"   // QXlsx header
 
 #include <complex>
@@ -56,6 +66,7 @@ public:
     static void writeToNotes(const QString &data);
     void initializeLogFile();
     void closeLogFile();
+    static LogRotationPolicy logRotationPolicy();   // [Logging] section of settings.ini
 
     quint8 calculateChecksum(const QByteArray &data);
     QString hexBytes(QByteArray &cmd);
@@ -78,8 +89,9 @@ public:
     void initializeAllPlots();
 
     void makePacket32UI(QList<QByteArray> &rawPacket32List);
-    void makePacket4100AdxlTempList(QList<QByteArray> &rawPacket4100AdxlList,QList<QByteArray> &rawPacketTemperatureList);
-    void makePacket4100InclList(QList<QByteArray> &rawPacket4100InclList);
+    void makePacket4100AdxlTempList(const QVector<double> &xAdxl, const QVector<double> &yAdxl,
+                                    const QVector<double> &zAdxl, const QVector<double> &temperatureValues);
+    void makePacket4100InclList(const QVector<double> &inclX, const QVector<double> &inclY);
 
     void makePacket4100AdxlLive(const QByteArray &rawPacket4100Adxl);
     void makePacket4100InclLive(const QByteArray &rawPacket4100Incl);
@@ -102,6 +114,9 @@ public:
    void computeAndPlotFFT(const QVector<double>& signal,
                           double Fs,
                           QCustomPlot *plot);
+   void plotSpectrum(const SignalProcessing::Spectrum &spectrum,
+                     double Fs,
+                     QCustomPlot *plot);
    void plotLiveFFT(const QVector<double>& signal,
                                 double Fs,
                                 QCustomPlot *plot);
@@ -117,13 +132,17 @@ private slots:
 
         void showGuiData(const QByteArray &byteArrayData);
 
+        // Get Event Data (msgId 0x01), decoded by serialPortHandler while it downloads
+        void showEventData(const EventStreamParser::Event &event);
+        void showEventProgress(qint64 bytesReceived, int adxlPackets, int inclPackets);
+        void displayEvent(const EventStreamParser::Event &event);
+        void logDamagedPackets(quint16 eventId, const EventStreamParser::Event &event);
+
         void dataProcessing(const QByteArray &byteArrayData);
 
         //response time handling
 
-        void handleTimeout();
-
-        void onDataReceived();
+        void handleTimeout(quint8 msgId, const QString &label);
 
         void on_pushButton_calibrateScreen_clicked();
 
@@ -160,6 +179,8 @@ private slots:
 
         void on_pushButton_remainingLogs_clicked();
 
+        void on_pushButton_downloadEvents_clicked();
+
         void on_pushButton_on_clicked();
 
         void on_pushButton_off_clicked();
@@ -168,10 +189,12 @@ private slots:
 
         void on_pushButton_currentParameters_clicked();
 
-        void livePlot(QCustomPlot *plot,
-                      const QVector<double> &xValues,
-                      const QVector<double> &yValues,
-                      int Window,int graphIndex);
+        void configureLiveStrips();
+        void refreshLivePlots();
+
+        // Flash padding statistics per device (serial port), see paddingscanner.h
+        void recordLivePadding(const PaddingScanner::ScanResult &scan, int removedBytes = 0);
+        void logPaddingStats(const QString &source, const PaddingScanner::Counters &counters);
 
         //fft functions
 
@@ -191,11 +214,14 @@ private slots:
        void on_pushButton_stopLivePlot_clicked();
        //void onUiUpdateTimer();
 
-       void saveLiveData(const QVector<double> &xAdxl,
-                                               const QVector<double> &yAdxl,
-                                               const QVector<double> &zAdxl,
-                                               const QVector<double> &inclX,
-                                               const QVector<double> &inclY);
+       bool saveLiveData(const QString &fullPath,
+                         SampleExport::Format format,
+                         const QVector<double> &xAdxl,
+                         const QVector<double> &yAdxl,
+                         const QVector<double> &zAdxl,
+                         const QVector<double> &inclX,
+                         const QVector<double> &inclY);
+       void finishLiveCapture();
        
        void on_pushButton_saveLive_clicked();
 
@@ -216,17 +242,35 @@ private:
     QCustomPlot *fftPlot;
     QList<QCPItemTracer*> fftTracers;
     QList<QCPItemText*>   fftLabels;
-    QTimer *saveLimitTimer;
 
 
-    //Log handling
-    static QFile logFile;
-    static QTextStream logStream;
     void setupPlot(QCustomPlot *plot, const QString &xLabel, const QString &yLabel,bool noClearGraph=0);
 
 
-    //Response Time waiting timer
-     QTimer *responseTimer = nullptr; // Timer to track response timeout
+    //Commands and their response timeouts
+     CommandScheduler *scheduler = nullptr;
+     void sendCommand(quint8 msgId, const QByteArray &command, const QString &label);
+
+    // Get Event Data downloads, answered in order; display == false : only stored in the event cache
+     struct EventRequest
+     {
+         quint16 eventId = 0;
+         bool display = true;
+         int attempt = 0;
+         bool retried = false;      // damaged, downloaded again by a later request
+         bool damaged = false;      // damaged packets left out, not cached
+     };
+     QQueue<EventRequest> eventRequests;
+     EventCache eventCache;
+     int batchTotal = 0;            // Download Events in progress when > 0
+     int batchDone = 0;
+     int batchFailed = 0;
+     int eventRetries = 0;          // [Integrity] eventRetries
+
+     void requestEvent(quint16 eventId, bool display, int attempt = 0);
+     void eventDownloadFinished(bool ok);
+     QString logEventStart(quint16 eventId) const;     // start time listed by Get Log Events, empty if not listed
+     void markCachedEvents();
 
     //Extras
      QElapsedTimer elapsedTimer;
@@ -236,7 +280,10 @@ private:
      QDialog *dlgPlot = nullptr;
      QDialog *eraseDlg=nullptr;
 
-      bool saveLive=false;
+     // Live capture to disk (Save Live), written in chunks while acquisition runs
+     LiveCaptureWriter liveWriter;
+     QString liveTargetPath;
+     SampleExport::Format liveTargetFormat = SampleExport::Format::Csv;
 
      // --- ADXL ---
      QVector<double> finalAdxlIndex;
@@ -253,11 +300,6 @@ private:
      QVector<double> finalInclX;
      QVector<double> finalInclY;
 
-     QList<QByteArray> packet32List;
-     QList<QByteArray> packet4100AdxlList;
-     QList<QByteArray> packet4100InclList;
-     QList<QByteArray> packetTemperatureList;
-
      quint16 adxlFreq;
      quint16 InclinometerFreq;
      quint16 eventId;
@@ -274,27 +316,26 @@ private:
      QVector<double> pending_yAdxl;
      QVector<double> pending_zAdxl;
 
-     // Full-history storage 
-     QVector<double> full_xAdxl;
-     QVector<double> full_yAdxl;
-     QVector<double> full_zAdxl;
-     
-     QVector<double> fullInclXL;
-     QVector<double> fullInclYL;
-
      // flags and tuning
      bool livePlotEnabled;   // controlled by your livePlot checkbox
      int uiUpdateIntervalMs =33;
 
-     quint16 adxlFreqL;
-     quint16 inclFreqL;
+     quint16 adxlFreqL = 0;
+     quint16 inclFreqL = 0;
 
-     int adxlWindow = -1;
-     int inclWindow = -1;
+     // Live time domain history (strip charts), sized from [LivePlot] windowSeconds
+     static const int LIVE_FALLBACK_RATE = 1000;    // until the live frequency packet arrives
+     StripChart adxlStrip[3];
+     StripChart inclStrip[2];
      double maxPeak_x = 0.0;
      double maxPeak_y = 0.0;
      double maxPeak_z = 0.0;
 
+     // Flash padding counters: per device since start-up, and for the running live acquisition
+     QString currentPortName;
+     QMap<QString, PaddingScanner::Counters> devicePadding;
+     PaddingScanner::Counters livePadding;
+
 
 };  
 #endif // MAINWINDOW_H
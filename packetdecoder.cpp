@@ -0,0 +1,427 @@
+#include "packetdecoder.h"
+
+#include <QDebug>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const char ADXL_FOOTER[] = "\xFF\xEE\xFF";
+    const char INCL_FOOTER[] = "\xFF\xCC\xDD";
+    const char EVENT_FOOTER[] = "\xAA\xBB\xCC\xDD\xFF";
+    const int EVENT_FOOTER_SIZE = 5;
+
+    // ---- Sample conversion into preallocated arrays ----
+    void decodeAdxlSamples(const uchar *payload, int samples, double *x, double *y, double *z)
+    {
+        for (int s = 0; s < samples; ++s, payload += 6)
+        {
+            // Keep last 12 bits only first 4 bits eliminate in a 16 bit integer
+            qint16 xRaw = ((payload[0] << 8) | payload[1]) & 0x0FFF;
+            qint16 yRaw = ((payload[2] << 8) | payload[3]) & 0x0FFF;
+            qint16 zRaw = ((payload[4] << 8) | payload[5]) & 0x0FFF;
+
+            // Raw -> voltage -> g (1.65 V offset, 6.3 mV/g)
+            x[s] = ((xRaw * 3.3 * 2) / 4096.0 - 1.65) / 0.0063;
+            y[s] = ((yRaw * 3.3 * 2) / 4096.0 - 1.65) / 0.0063;
+            z[s] = ((zRaw * 3.3 * 2) / 4096.0 - 1.65) / 0.0063;
+        }
+    }
+
+    void decodeInclSamples(const uchar *payload, int samples, double *inclX, double *inclY)
+    {
+        // Each 4-byte sample (Xg, Yg)
+        for (int s = 0; s < samples; ++s, payload += 4)
+        {
+            qint16 xRaw = static_cast<qint16>((payload[1] << 8) | payload[0]);
+            qint16 yRaw = static_cast<qint16>((payload[3] << 8) | payload[2]);
+
+            // Convert to g-values, clamp to [-1, 1]
+            double xg = std::max(-1.0, std::min(1.0, (xRaw * 0.031) / 1000.0));
+            double yg = std::max(-1.0, std::min(1.0, (yRaw * 0.031) / 1000.0));
+
+            // Convert to degrees
+            inclX[s] = std::asin(xg) * (180.0 / M_PI);
+            inclY[s] = std::asin(yg) * (180.0 / M_PI);
+        }
+    }
+
+    // ---- Parallel event decode ----
+    struct DecodeJob
+    {
+        const char *data = nullptr;
+        const PacketDecoder::EventIndex *index = nullptr;
+        const int *adxlOffsets = nullptr;     // first sample of each packet
+        const int *inclOffsets = nullptr;
+        double *adxl[3] = { nullptr, nullptr, nullptr };
+        double *temperature = nullptr;
+        double *incl[2] = { nullptr, nullptr };
+    };
+
+    // Packets [first, last) of the combined ADXL + inclinometer list
+    void decodePackets(const DecodeJob &job, int first, int last)
+    {
+        const int adxlCount = job.index->adxlPackets.size();
+        const uchar *data = reinterpret_cast<const uchar *>(job.data);
+
+        for (int p = first; p < last; ++p)
+        {
+            if (p < adxlCount)
+            {
+                const PacketDecoder::PacketRef &ref = job.index->adxlPackets[p];
+                const int offset = job.adxlOffsets[p];
+                decodeAdxlSamples(data + ref.offset + PacketDecoder::HEADER_SIZE, PacketDecoder::adxlSampleCount(ref),
+                                  job.adxl[0] + offset, job.adxl[1] + offset, job.adxl[2] + offset);
+                job.temperature[p] = PacketDecoder::packetTemperature(job.data + ref.offset);
+            }
+            else
+            {
+                const int i = p - adxlCount;
+                const PacketDecoder::PacketRef &ref = job.index->inclPackets[i];
+                const int offset = job.inclOffsets[i];
+                decodeInclSamples(data + ref.offset + PacketDecoder::HEADER_SIZE, PacketDecoder::inclSampleCount(ref),
+                                  job.incl[0] + offset, job.incl[1] + offset);
+            }
+        }
+    }
+
+    class DecodeTask : public QRunnable
+    {
+    public:
+        DecodeTask(const DecodeJob &job, int first, int last) : mJob(job), mFirst(first), mLast(last) {}
+        void run() override { decodePackets(mJob, mFirst, mLast); }
+
+    private:
+        const DecodeJob &mJob;
+        int mFirst;
+        int mLast;
+    };
+
+    const int PACKETS_PER_TASK = 8;     // ~5k ADXL samples, large enough to amortise the task
+}
+
+PacketDecoder::PacketType PacketDecoder::packetType(const char *header)
+{
+    const uchar *h = reinterpret_cast<const uchar *>(header);
+
+    if (h[0] == 0xAA && h[1] == 0xBB)
+        return PacketType::Packet32;
+    if (h[0] == 0xCC && h[1] == 0xDD && h[2] == 0xFF)
+        return PacketType::Adxl;
+    if (h[0] == 0xEE && h[1] == 0xFF && h[2] == 0xFF)
+        return PacketType::Incl;
+    return PacketType::Unknown;
+}
+
+bool PacketDecoder::hasValidFooter(PacketType type, const char *packet4100)
+{
+    const char *footer = packet4100 + PACKET4100_SIZE - FOOTER_SIZE;
+    if (type == PacketType::Adxl)
+        return memcmp(footer, ADXL_FOOTER, FOOTER_SIZE) == 0;
+    if (type == PacketType::Incl)
+        return memcmp(footer, INCL_FOOTER, FOOTER_SIZE) == 0;
+    return false;
+}
+
+PacketDecoder::PacketRef PacketDecoder::referencePacket(const char *packet4100, int offset, bool adxl, int packetIndex,
+                                                        QList<PaddingInfo> &paddingList,
+                                                        PaddingScanner::Counters *counters)
+{
+    PacketRef ref;
+    ref.offset = offset;
+
+    // One pass for the padding position and the FF statistics of the packet
+    const PaddingScanner::ScanResult scan = PaddingScanner::scan(packet4100, PACKET4100_SIZE);
+    const int fIndex = scan.firstRun;
+    if (fIndex < 0)
+    {
+        if (counters)
+            counters->add(scan);
+        return ref;
+    }
+
+    // The padding runs up to the temperature/dummy bytes, the payload simply ends where it starts
+    ref.payloadSize = qBound(0, fIndex - HEADER_SIZE, PAYLOAD_SIZE);
+
+    PaddingInfo info;
+    info.adxl = adxl;
+    info.packetIndex = packetIndex;
+    info.fIndex = fIndex;
+    info.removedBytes = (PACKET4100_SIZE - fIndex) - (TRAILER_SIZE + FOOTER_SIZE);
+    paddingList.append(info);
+
+    if (counters)
+        counters->add(scan, info.removedBytes);
+
+    return ref;
+}
+
+bool PacketDecoder::findResync(const char *data, int size, int from, int &position)
+{
+    for (int j = from; j < size; ++j)
+    {
+        const int left = size - j;
+        position = j;
+        if (left < HEADER_SIZE)
+            return false;
+
+        const PacketType type = packetType(data + j);
+        if (type == PacketType::Unknown)
+            continue;
+
+        if (type == PacketType::Packet32)
+        {
+            // Event footer, complete or still arriving
+            if (memcmp(data + j, EVENT_FOOTER, qMin(left, EVENT_FOOTER_SIZE)) == 0)
+            {
+                if (left < EVENT_FOOTER_SIZE)
+                    return false;
+                return true;
+            }
+
+            // Packet32 followed by the next header
+            if (left < PACKET32_SIZE + HEADER_SIZE)
+                return false;
+            if (packetType(data + j + PACKET32_SIZE) != PacketType::Unknown)
+                return true;
+            continue;
+        }
+
+        if (left < PACKET4100_SIZE)
+            return false;
+        if (hasValidFooter(type, data + j))
+            return true;
+    }
+
+    position = size;
+    return false;
+}
+
+bool PacketDecoder::endsWithEventFooter(const char *data, int size)
+{
+    return size >= EVENT_FOOTER_SIZE && memcmp(data + size - EVENT_FOOTER_SIZE, EVENT_FOOTER, EVENT_FOOTER_SIZE) == 0;
+}
+
+void PacketDecoder::indexEventResponse(const char *data, int size, EventIndex &index)
+{
+    int i = 0;
+
+    // Upper bound, reserved once instead of growing per packet
+    index.adxlPackets.reserve(size / PACKET4100_SIZE);
+    index.inclPackets.reserve(size / PACKET4100_SIZE);
+
+    //  Make sure we have at least 3 bytes for a header
+    while (i + HEADER_SIZE <= size)
+    {
+        const PacketType type = packetType(data + i);
+        const char *packet = data + i;
+        bool valid = true;
+
+        if (type == PacketType::Unknown)
+        {
+            qDebug() << "Unknown header" << QByteArray::fromRawData(data + i, HEADER_SIZE).toHex() << "at" << i;
+            valid = false;
+        }
+        else if (i + packetSize(type) > size)
+        {
+            // Incomplete packet at end (the AA BB CC DD FF footer included), a 4100 byte one lost bytes on the way
+            if (type != PacketType::Packet32)
+            {
+                DamagedPacket damaged;
+                damaged.type = type;
+                damaged.offset = i;
+                damaged.header = QByteArray(data + i, HEADER_SIZE);
+                damaged.skippedBytes = size - i - (endsWithEventFooter(data, size) ? EVENT_FOOTER_SIZE : 0);
+                index.damaged.append(damaged);
+                index.invalidHeaderCount++;
+            }
+            break;
+        }
+
+        switch (type)
+        {
+        case PacketType::Packet32:
+            index.packet32Offsets.append(i);
+            break;
+
+        case PacketType::Adxl:
+            valid = hasValidFooter(type, packet);
+            if (valid)
+                index.adxlPackets.append(referencePacket(packet, i, true, index.adxlPackets.size(), index.paddingList,
+                                                           &index.padding));
+            break;
+
+        case PacketType::Incl:
+            valid = hasValidFooter(type, packet);
+            if (valid)
+                index.inclPackets.append(referencePacket(packet, i, false, index.inclPackets.size(), index.paddingList,
+                                                           &index.padding));
+            break;
+
+        case PacketType::Unknown:
+            break;
+        }
+
+        if (valid)
+        {
+            i += packetSize(type);
+            continue;
+        }
+
+        // --- Damaged packet: resume at the next header the packet structure confirms ---
+        DamagedPacket damaged;
+        damaged.type = type;
+        damaged.offset = i;
+        damaged.header = QByteArray(data + i, HEADER_SIZE);
+
+        int next = size;
+        if (!findResync(data, size, i + 1, next))
+            next = size - (endsWithEventFooter(data, size) ? EVENT_FOOTER_SIZE : 0);   // nothing left but the footer
+        damaged.skippedBytes = qMax(0, next - i);
+
+        qDebug() << "Damaged packet at" << i << "type" << int(type) << "skipped" << damaged.skippedBytes << "bytes";
+        index.damaged.append(damaged);
+        index.invalidHeaderCount++;
+        i = qMax(next, i + 1);
+    }
+}
+
+int PacketDecoder::decodeAdxlPayload(const char *data, const PacketRef &ref,
+                                     QVector<double> &xAdxl,
+                                     QVector<double> &yAdxl,
+                                     QVector<double> &zAdxl)
+{
+    // Payload without header, footer and temperature bytes
+    const int samples = adxlSampleCount(ref);
+    if (samples == 0)
+    {
+        qDebug() << "Skipping too short ADXL packet:" << ref.payloadSize;
+        return 0;
+    }
+
+    const int start = xAdxl.size();
+    xAdxl.resize(start + samples);
+    yAdxl.resize(start + samples);
+    zAdxl.resize(start + samples);
+
+    decodeAdxlSamples(reinterpret_cast<const uchar *>(data) + ref.offset + HEADER_SIZE, samples,
+                      xAdxl.data() + start, yAdxl.data() + start, zAdxl.data() + start);
+    return samples;
+}
+
+int PacketDecoder::decodeInclPayload(const char *data, const PacketRef &ref,
+                                     QVector<double> &inclX,
+                                     QVector<double> &inclY)
+{
+    // Payload without header, footer and last 2 dummy bytes
+    const int samples = inclSampleCount(ref);
+    if (samples == 0)
+    {
+        qDebug() << "Skipping too short Inclinometer packet:" << ref.payloadSize;
+        return 0;
+    }
+
+    const int start = inclX.size();
+    inclX.resize(start + samples);
+    inclY.resize(start + samples);
+
+    decodeInclSamples(reinterpret_cast<const uchar *>(data) + ref.offset + HEADER_SIZE, samples,
+                      inclX.data() + start, inclY.data() + start);
+    return samples;
+}
+
+void PacketDecoder::decodeEvent(const char *data, const EventIndex &index, EventSamples &samples, int maxThreads)
+{
+    // ---- Output offset of every packet, so packets can be decoded in any order ----
+    QVector<int> adxlOffsets(index.adxlPackets.size());
+    int adxlTotal = 0;
+    for (int p = 0; p < index.adxlPackets.size(); ++p)
+    {
+        adxlOffsets[p] = adxlTotal;
+        adxlTotal += adxlSampleCount(index.adxlPackets[p]);
+    }
+
+    QVector<int> inclOffsets(index.inclPackets.size());
+    int inclTotal = 0;
+    for (int p = 0; p < index.inclPackets.size(); ++p)
+    {
+        inclOffsets[p] = inclTotal;
+        inclTotal += inclSampleCount(index.inclPackets[p]);
+    }
+
+    samples.xAdxl.resize(adxlTotal);
+    samples.yAdxl.resize(adxlTotal);
+    samples.zAdxl.resize(adxlTotal);
+    samples.temperature.resize(index.adxlPackets.size());
+    samples.inclX.resize(inclTotal);
+    samples.inclY.resize(inclTotal);
+
+    // Detached here, the workers only write through these pointers
+    DecodeJob job;
+    job.data = data;
+    job.index = &index;
+    job.adxlOffsets = adxlOffsets.constData();
+    job.inclOffsets = inclOffsets.constData();
+    job.adxl[0] = samples.xAdxl.data();
+    job.adxl[1] = samples.yAdxl.data();
+    job.adxl[2] = samples.zAdxl.data();
+    job.temperature = samples.temperature.data();
+    job.incl[0] = samples.inclX.data();
+    job.incl[1] = samples.inclY.data();
+
+    // ---- Packets decoded concurrently in batches ----
+    const int packets = index.adxlPackets.size() + index.inclPackets.size();
+    const int threads = qMin(maxThreads > 0 ? maxThreads : QThread::idealThreadCount(),
+                             (packets + PACKETS_PER_TASK - 1) / PACKETS_PER_TASK);
+    if (threads <= 1)
+    {
+        decodePackets(job, 0, packets);
+        return;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (int first = 0; first < packets; first += PACKETS_PER_TASK)
+        pool.start(new DecodeTask(job, first, qMin(first + PACKETS_PER_TASK, packets)));
+    pool.waitForDone();
+}
+
+int PacketDecoder::decodeAdxlPacket(const QByteArray &packet,
+                                    QVector<double> &xAdxl,
+                                    QVector<double> &yAdxl,
+                                    QVector<double> &zAdxl)
+{
+    PacketRef ref;
+    ref.payloadSize = packet.size() - (HEADER_SIZE + FOOTER_SIZE + TRAILER_SIZE);
+    return decodeAdxlPayload(packet.constData(), ref, xAdxl, yAdxl, zAdxl);
+}
+
+int PacketDecoder::decodeInclPacket(const QByteArray &packet,
+                                    QVector<double> &inclX,
+                                    QVector<double> &inclY)
+{
+    PacketRef ref;
+    ref.payloadSize = packet.size() - (HEADER_SIZE + FOOTER_SIZE + TRAILER_SIZE);
+    return decodeInclPayload(packet.constData(), ref, inclX, inclY);
+}
+
+double PacketDecoder::decodeTemperature(quint8 msb, quint8 lsb)
+{
+    quint16 tempRaw = (msb << 8) | lsb;
+
+    // Keep first 14 bits only last 2 bits eliminate in a 16 bit integer
+    tempRaw &= ~0x0003;
+
+    return -46.85 + (175.72 * tempRaw) / 65536.0;
+}
+
+double PacketDecoder::packetTemperature(const char *packet4100)
+{
+    // Last 2 bytes before the footer, never moved by the padding
+    const int pos = PACKET4100_SIZE - (TRAILER_SIZE + FOOTER_SIZE);
+    return decodeTemperature(static_cast<quint8>(packet4100[pos]), static_cast<quint8>(packet4100[pos + 1]));
+}
@@ -0,0 +1,142 @@
+#ifndef PACKETDECODER_H
+#define PACKETDECODER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include "paddingscanner.h"
+
+// Packet layout of the Get Event Data (msgId 0x01) response
+//   Packet32       : AA BB ... (32 bytes, event header)
+//   Packet4100 ADXL: CC DD FF | 682 x (X,Y,Z big-endian 12 bit) | temp(2) | FF EE FF
+//   Packet4100 Incl: EE FF FF | 1023 x (X,Y little-endian 16 bit) | dummy(2) | FF CC DD
+namespace PacketDecoder
+{
+    const int PACKET32_SIZE   = 32;
+    const int PACKET4100_SIZE = 4100;
+    const int HEADER_SIZE     = 3;
+    const int FOOTER_SIZE     = 3;
+    const int TRAILER_SIZE    = 2;     // temperature (ADXL) / dummy (Inclinometer) bytes before footer
+    const int PAYLOAD_SIZE    = PACKET4100_SIZE - (HEADER_SIZE + TRAILER_SIZE + FOOTER_SIZE);
+
+    enum class PacketType
+    {
+        Packet32,
+        Adxl,
+        Incl,
+        Unknown
+    };
+
+    // One flash padding (6+ consecutive FF's) found in a packet, the FF's are left out of its payload
+    struct PaddingInfo
+    {
+        bool adxl = true;              // false : inclinometer packet
+        int packetIndex = 0;
+        int fIndex = 0;                // start of the FF run inside the packet
+        int removedBytes = 0;
+    };
+
+    // One 4100 byte packet inside the received response, decoded in place (no copy)
+    struct PacketRef
+    {
+        int offset = 0;                // header position in the response
+        int payloadSize = PAYLOAD_SIZE;    // sample bytes after the header, padding excluded
+    };
+
+    // Bytes left out of an event: a 4100 byte packet whose footer doesn't match its header (Adxl / Incl), or bytes
+    // with no known header (Unknown). The response carries no checksum, header + footer are the only integrity check;
+    // parsing resumes at the next header confirmed by the packet structure (see findResync)
+    struct DamagedPacket
+    {
+        PacketType type = PacketType::Unknown;
+        int offset = 0;                // position in the response
+        int skippedBytes = 0;          // up to the header parsing resumed at (or the end of the event)
+        QByteArray header;             // first HEADER_SIZE bytes at offset, for the notes
+    };
+
+    // Packet offsets of one complete event response, the response itself is not copied
+    struct EventIndex
+    {
+        QVector<int> packet32Offsets;
+        QVector<PacketRef> adxlPackets;
+        QVector<PacketRef> inclPackets;
+        QList<PaddingInfo> paddingList;
+        PaddingScanner::Counters padding;      // FF statistics of the 4100 byte packets
+        QList<DamagedPacket> damaged;
+        int invalidHeaderCount = 0;
+    };
+
+    // Type of the packet whose first HEADER_SIZE bytes are at header
+    PacketType packetType(const char *header);
+
+    // Bytes a packet occupies in the response (an unknown header is skipped by a whole 4100 packet)
+    inline int packetSize(PacketType type) { return type == PacketType::Packet32 ? PACKET32_SIZE : PACKET4100_SIZE; }
+
+    // True when the 4100 byte packet ends with the footer of its type
+    bool hasValidFooter(PacketType type, const char *packet4100);
+
+    // Where the packet stream continues after damaged bytes, searching data[from, size): a 4100 byte header counts
+    // once its footer matches, an AA BB header once it is the event footer or another header follows the Packet32.
+    // True : header at position. False : nothing before position can be a header, the bytes from position on
+    // can't be decided until more data arrives
+    bool findResync(const char *data, int size, int from, int &position);
+
+    // True when the bytes end with the "AA BB CC DD FF" event footer
+    bool endsWithEventFooter(const char *data, int size);
+
+    // Reference to a valid 4100 byte packet at offset, the payload stops at the flash padding if there is one
+    // (recorded in paddingList with packetIndex, the packet's FF statistics go to counters)
+    PacketRef referencePacket(const char *packet4100, int offset, bool adxl, int packetIndex,
+                              QList<PaddingInfo> &paddingList, PaddingScanner::Counters *counters = nullptr);
+
+    // Walks a complete "AA BB ... AA BB CC DD FF" response and records where its packets are
+    void indexEventResponse(const char *data, int size, EventIndex &index);
+    inline void indexEventResponse(const QByteArray &data, EventIndex &index)
+    {
+        indexEventResponse(data.constData(), data.size(), index);
+    }
+
+    // Decodes the payload of one ADXL packet in place (ref is relative to data) and appends the samples in g
+    // Returns the number of samples appended
+    int decodeAdxlPayload(const char *data, const PacketRef &ref,
+                          QVector<double> &xAdxl,
+                          QVector<double> &yAdxl,
+                          QVector<double> &zAdxl);
+
+    // Decodes the payload of one inclinometer packet in place and appends the samples in degrees
+    int decodeInclPayload(const char *data, const PacketRef &ref,
+                          QVector<double> &inclX,
+                          QVector<double> &inclY);
+
+    // Samples of a whole indexed event
+    struct EventSamples
+    {
+        QVector<double> xAdxl, yAdxl, zAdxl;    // g
+        QVector<double> temperature;            // °C, one per ADXL packet
+        QVector<double> inclX, inclY;           // degrees
+    };
+
+    // Decodes every packet of the index: output offsets are computed up front, then batches of packets
+    // are decoded concurrently straight into the preallocated arrays (maxThreads <= 0 : ideal thread count)
+    void decodeEvent(const char *data, const EventIndex &index, EventSamples &samples, int maxThreads = 0);
+
+    // Samples a packet payload holds (0 when it is too short to decode)
+    inline int adxlSampleCount(const PacketRef &ref) { return ref.payloadSize < 12 ? 0 : ref.payloadSize / 6; }
+    inline int inclSampleCount(const PacketRef &ref) { return ref.payloadSize < 12 ? 0 : ref.payloadSize / 4; }
+
+    // Whole packet variants (header/footer included, no padding), used by the live path
+    int decodeAdxlPacket(const QByteArray &packet,
+                         QVector<double> &xAdxl,
+                         QVector<double> &yAdxl,
+                         QVector<double> &zAdxl);
+    int decodeInclPacket(const QByteArray &packet,
+                         QVector<double> &inclX,
+                         QVector<double> &inclY);
+
+    // Temperature in °C from the 2 raw bytes stored before the ADXL footer
+    double decodeTemperature(quint8 msb, quint8 lsb);
+    double packetTemperature(const char *packet4100);
+}
+
+#endif // PACKETDECODER_H
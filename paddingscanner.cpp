@@ -0,0 +1,160 @@
+#include "paddingscanner.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PADDINGSCANNER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    // Index of the lowest set bit, mask != 0
+    inline int lowestBit(quint32 mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return int(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // Run bookkeeping shared by the SIMD and the scalar loop
+    class RunTracker
+    {
+    public:
+        RunTracker(PaddingScanner::ScanResult &result, int minRun) : mResult(result), mMinRun(minRun) {}
+
+        void ffs(int pos, int count)
+        {
+            if (mLength == 0)
+                mStart = pos;
+            mLength += count;
+            mResult.ffBytes += count;
+        }
+
+        void other()
+        {
+            if (mLength == 0)
+                return;
+
+            mResult.longestRun = qMax(mResult.longestRun, mLength);
+            if (mLength >= mMinRun)
+            {
+                mResult.runs++;
+                if (mResult.firstRun < 0)
+                {
+                    mResult.firstRun = mStart;
+                    mResult.firstRunLength = mLength;
+                }
+            }
+            mLength = 0;
+        }
+
+        void finish()
+        {
+            const int trailing = mLength;
+            other();
+            mResult.trailingFF = trailing;
+        }
+
+    private:
+        PaddingScanner::ScanResult &mResult;
+        int mMinRun;
+        int mStart = 0;
+        int mLength = 0;
+    };
+}
+
+PaddingScanner::ScanResult PaddingScanner::scan(const char *data, int size, int minRun)
+{
+    ScanResult result;
+    RunTracker runs(result, qMax(1, minRun));
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    int i = 0;
+
+#ifdef PADDINGSCANNER_SSE2
+    // 16 bytes per step: all FF and no FF blocks (nearly every block) cost one compare
+    const __m128i ff = _mm_set1_epi8(char(0xFF));
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        const quint32 mask = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(block, ff)));
+
+        if (mask == 0xFFFF)
+        {
+            runs.ffs(i, 16);
+            continue;
+        }
+        if (mask == 0)
+        {
+            runs.other();
+            continue;
+        }
+
+        // Mixed block, walk it run by run
+        int bit = 0;
+        while (bit < 16)
+        {
+            const quint32 rest = mask >> bit;
+            if (rest & 1)
+            {
+                const int length = lowestBit(~rest);     // bit 16 - bit of ~rest is always set
+                runs.ffs(i + bit, length);
+                bit += length;
+            }
+            else
+            {
+                runs.other();
+                if (rest == 0)
+                    break;
+                bit += lowestBit(rest);
+            }
+        }
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        if (p[i] == 0xFF)
+            runs.ffs(i, 1);
+        else
+            runs.other();
+    }
+
+    runs.finish();
+    return result;
+}
+
+int PaddingScanner::trailingFF(const char *data, int size)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    int i = size;
+
+#ifdef PADDINGSCANNER_SSE2
+    const __m128i ff = _mm_set1_epi8(char(0xFF));
+    while (i >= 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i - 16));
+        const quint32 mask = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(block, ff)));
+        if (mask != 0xFFFF)
+        {
+            // Highest non FF byte of the block ends the run
+            const quint32 others = ~mask & 0xFFFF;
+            int last = 15;
+            while (!(others & (1u << last)))
+                --last;
+            return size - (i - 16 + last + 1);
+        }
+        i -= 16;
+    }
+#endif
+
+    while (i > 0 && p[i - 1] == 0xFF)
+        --i;
+    return size - i;
+}
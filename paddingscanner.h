@@ -0,0 +1,64 @@
+#ifndef PADDINGSCANNER_H
+#define PADDINGSCANNER_H
+
+#include <QtGlobal>
+
+// Flash padding / corruption scanner for 0xFF runs
+// One pass over a packet (16 bytes at a time with SSE2, byte by byte elsewhere) reports the first run of
+// minRun+ FF's, which is where the flash padding starts, together with the FF statistics of the packet.
+namespace PaddingScanner
+{
+    const int DEFAULT_MIN_RUN = 6;      // FF's in a row that mark the flash padding
+
+    struct ScanResult
+    {
+        int firstRun = -1;              // start of the first run of minRun+ FF's, -1 when there is none
+        int firstRunLength = 0;
+        int runs = 0;                   // runs of minRun+ FF's
+        int longestRun = 0;             // longest run of FF's of any length
+        int ffBytes = 0;                // FF bytes in total
+        int trailingFF = 0;             // FF's at the very end
+
+        bool padded() const { return firstRun >= 0; }
+    };
+
+    ScanResult scan(const char *data, int size, int minRun = DEFAULT_MIN_RUN);
+
+    // FF's right before data + size, same answer as scan().trailingFF without walking the whole buffer
+    int trailingFF(const char *data, int size);
+
+    // Running totals over many packets, e.g. per device for monitoring how often the flash padding shows up
+    struct Counters
+    {
+        qint64 packets = 0;
+        qint64 paddedPackets = 0;
+        qint64 paddingRuns = 0;
+        qint64 ffBytes = 0;
+        qint64 removedBytes = 0;        // FF's left out of the payloads
+        int longestRun = 0;
+
+        void add(const ScanResult &result, int removed = 0)
+        {
+            packets++;
+            paddedPackets += result.padded() ? 1 : 0;
+            paddingRuns += result.runs;
+            ffBytes += result.ffBytes;
+            removedBytes += removed;
+            longestRun = qMax(longestRun, result.longestRun);
+        }
+
+        void add(const Counters &other)
+        {
+            packets += other.packets;
+            paddedPackets += other.paddedPackets;
+            paddingRuns += other.paddingRuns;
+            ffBytes += other.ffBytes;
+            removedBytes += other.removedBytes;
+            longestRun = qMax(longestRun, other.longestRun);
+        }
+
+        double paddedPercent() const { return packets > 0 ? 100.0 * paddedPackets / packets : 0.0; }
+    };
+}
+
+#endif // PADDINGSCANNER_H
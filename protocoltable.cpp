@@ -0,0 +1,229 @@
+#include "protocoltable.h"
+
+using namespace ProtocolTable;
+
+namespace
+{
+    Response response(Match match, const char *prefixHex, const char *suffixHex, const char *label,
+                      Note note = Note::Hex, Delivery delivery = Delivery::Gui)
+    {
+        Response r;
+        r.match = match;
+        r.prefix = QByteArray::fromHex(prefixHex);
+        r.suffix = QByteArray::fromHex(suffixHex);
+        r.label = label;
+        r.note = note;
+        r.delivery = delivery;
+        return r;
+    }
+
+    Response startsWith(const char *hex, const char *label)
+    {
+        return response(Match::StartsWith, hex, "", label);
+    }
+
+    // Data frames of Start Log (0x02), Live Plot (0x12) and the ones still arriving after Live Plot Stop (0x11)
+    QVector<Response> liveFrames()
+    {
+        QVector<Response> responses;
+
+        Response freq = response(Match::Frame, "AA BB", "FF FF", "Live Frequency Packet:", Note::Size, Delivery::Live);
+        freq.completes = false;
+        freq.trace = TraceEvent::LiveFreqPacket;
+        responses << freq;
+
+        Response adxl = response(Match::Frame, "CC DD FF", "EE FF", "ADXL Packet:", Note::Size, Delivery::Live);
+        adxl.completes = false;
+        adxl.trace = TraceEvent::AdxlPacket;
+        adxl.counter = Counter::AdxlPackets;
+        responses << adxl;
+
+        Response incl = response(Match::Frame, "EE FF FF", "CC DD", "Incl Packet:", Note::Size, Delivery::Live);
+        incl.completes = false;
+        incl.trace = TraceEvent::InclPacket;
+        incl.counter = Counter::InclPackets;
+        responses << incl;
+
+        return responses;
+    }
+
+    // Frames shared by Start Log (0x02) and Live Plot (0x12)
+    QVector<Response> liveResponses()
+    {
+        QVector<Response> responses;
+        responses << response(Match::StartsWith, "54 53 41 43 4B", "", "Start Log Initial cmd received", Note::Text);
+        responses << response(Match::StartsWith, "54 53 50", "", "Start Log End cmd received", Note::Text);
+        responses << liveFrames();
+        return responses;
+    }
+
+    QVector<Command> buildCommands()
+    {
+        QVector<Command> commands;
+        Command c;
+
+        // ---- 0x01 Get Event Data ----
+        c = Command();
+        c.msgId = 0x01;
+        c.handling = Handling::Event;
+        commands << c;
+
+        // ---- 0x02 Start Log ----
+        c = Command();
+        c.msgId = 0x02;
+        c.handling = Handling::Live;
+        c.responses = liveResponses();
+        commands << c;
+
+        // ---- 0x03 Get Log Events ----
+        c = Command();
+        c.msgId = 0x03;
+        c.responses << response(Match::StartsAndEndsWith, "AA BB", "65 6E 64 FF EF EE",
+                                "Get Log Events cmd received bytes: ", Note::DebugHex);
+        c.incompleteNote = "Required  bytes with header AA BB and footer 65 6E 64 FF EF EE, bytes Received bytes: ";
+        commands << c;
+
+        // ---- 0x04 Stop Plot ----
+        c = Command();
+        c.msgId = 0x04;
+        c.responses << response(Match::Equals, "53 54 46", "", "Stop Plot cmd received bytes: ");
+        c.incompleteNote = "Required 3, bytes Received bytes: ";
+        commands << c;
+
+        // ---- 0x05 Remaining ----
+        c = Command();
+        c.msgId = 0x05;
+        c.responses << startsWith("53 54 54", "Remaining cmd received bytes: ");
+        c.incompleteNote = "Required 3, bytes Received bytes: ";
+        commands << c;
+
+        // ---- 0x06 System On ----
+        c = Command();
+        c.msgId = 0x06;
+        c.responses << startsWith("53 54 55", "System on Data cmd received bytes: ");
+        c.incompleteNote = "Required 3, bytes Received bytes: ";
+        commands << c;
+
+        // ---- 0x07 Erase (acknowledge, then done) ----
+        c = Command();
+        c.msgId = 0x07;
+        c.responses << startsWith("54 53 41 43 4C", "Erase command Received bytes:");
+        c.responses << response(Match::Equals, "54 53 44 4F 4E 45", "", "Erase command Received bytes:");
+        commands << c;
+
+        // ---- 0x08 / 0x09 Power On / Off ----
+        c = Command();
+        c.msgId = 0x08;
+        c.responses << startsWith("53 54 47", "power on command Received bytes:");
+        commands << c;
+
+        c = Command();
+        c.msgId = 0x09;
+        c.responses << startsWith("53 54 48", "power off command Received bytes:");
+        commands << c;
+
+        // ---- 0x10 Settings ----
+        c = Command();
+        c.msgId = 0x10;
+        c.responses << startsWith("53 54 44", "log Time Response Received bytes:");
+        c.responses << startsWith("53 54 51", "Threshold Response Received bytes:");
+        c.responses << startsWith("53 54 49", "Set Time Response Received bytes:");
+        c.responses << startsWith("53 54 52", "ADXL Sampling frequency Response Received bytes:");
+        c.responses << startsWith("53 54 53", "Inclinometer frequency Response Received bytes:");
+        commands << c;
+
+        // ---- 0x11 Live Plot Stop (frames sent before the stop still go to the live capture) ----
+        c = Command();
+        c.msgId = 0x11;
+        c.handling = Handling::Live;
+        Response stop = response(Match::StartsWith, "54 53 50", "", "LivePlot stop Response Received bytes:",
+                                 Note::DebugHex, Delivery::None);
+        stop.liveTotals = true;
+        c.responses << stop;
+        c.responses << liveFrames();
+        commands << c;
+
+        // ---- 0x12 Live Plot (live check acknowledge first) ----
+        c = Command();
+        c.msgId = 0x12;
+        c.handling = Handling::Live;
+        c.responses << response(Match::StartsWith, "53 54 56", "", "Start Log Initial cmd received",
+                                Note::Text, Delivery::None);
+        c.responses << liveResponses();
+        commands << c;
+
+        return commands;
+    }
+
+    struct Table
+    {
+        QVector<Command> commands;
+        const Command *byId[256] = {};
+
+        Table() : commands(buildCommands())
+        {
+            for (Command &command : commands)
+            {
+                for (int i = 0; i < command.responses.size(); ++i)
+                {
+                    const QByteArray &prefix = command.responses[i].prefix;
+                    if (prefix.isEmpty())
+                        command.suffixOnly.append(i);
+                    else
+                        command.byFirstByte[quint8(prefix[0])].append(i);
+                }
+                byId[command.msgId] = &command;
+            }
+        }
+    };
+
+    const Table &table()
+    {
+        static const Table instance;
+        return instance;
+    }
+}
+
+const Command *ProtocolTable::command(quint8 msgId)
+{
+    return table().byId[msgId];
+}
+
+namespace
+{
+    bool matches(const Response &response, const QByteArray &buffer)
+    {
+        switch (response.match)
+        {
+        case Match::StartsWith:
+        case Match::Frame:
+            return buffer.startsWith(response.prefix);
+        case Match::EndsWith:
+            return buffer.endsWith(response.suffix);
+        case Match::StartsAndEndsWith:
+            return buffer.startsWith(response.prefix) && buffer.endsWith(response.suffix);
+        case Match::Equals:
+            return buffer == response.prefix;
+        }
+        return false;
+    }
+}
+
+const Response *ProtocolTable::match(const Command &command, const QByteArray &buffer)
+{
+    if (!buffer.isEmpty())
+    {
+        for (int i : command.byFirstByte[quint8(buffer[0])])
+        {
+            if (matches(command.responses[i], buffer))
+                return &command.responses[i];
+        }
+    }
+
+    for (int i : command.suffixOnly)
+    {
+        if (matches(command.responses[i], buffer))
+            return &command.responses[i];
+    }
+    return nullptr;
+}
@@ -0,0 +1,89 @@
+#ifndef PROTOCOLTABLE_H
+#define PROTOCOLTABLE_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "tracelog.h"
+
+// Response signatures of every command (msgId), built once and looked up by msgId
+// Adding a command is one entry in protocoltable.cpp, serialPortHandler::readData stays as it is.
+namespace ProtocolTable
+{
+    // How the bytes of a command's response are consumed
+    enum class Handling
+    {
+        Event,          // Get Event Data, fed chunk by chunk to EventStreamParser
+        Live,           // stream of frames, each matched frame is cut from the front of the buffer
+        Framed          // one response, the whole buffer once it matches
+    };
+
+    enum class Match
+    {
+        StartsWith,
+        EndsWith,
+        StartsAndEndsWith,
+        Equals,
+        Frame           // live : prefix, then wait for suffix (frame footer)
+    };
+
+    // Where a matched response goes
+    enum class Delivery
+    {
+        None,
+        Gui,            // guiDisplay
+        Live            // liveData
+    };
+
+    // How the response is written to debug_notes.txt
+    enum class Note
+    {
+        Text,           // note only
+        Hex,            // note + hex of the response
+        DebugHex,       // note + hex, only when the logger is at Debug
+        Size            // note + " size = n" (+ hex at Trace)
+    };
+
+    enum class Counter
+    {
+        None,
+        AdxlPackets,
+        InclPackets
+    };
+
+    struct Response
+    {
+        Match match = Match::StartsWith;
+        QByteArray prefix;
+        QByteArray suffix;
+        Delivery delivery = Delivery::Gui;
+        bool completes = true;          // ends the command's response (receive summary + Response trace record)
+        Note note = Note::Hex;
+        const char *label = "";
+        TraceEvent trace = TraceEvent::Response;   // record of an incomplete (live) frame
+        Counter counter = Counter::None;
+        bool liveTotals = false;        // also log the live packet counters
+    };
+
+    struct Command
+    {
+        quint8 msgId = 0;
+        Handling handling = Handling::Framed;
+        QVector<Response> responses;
+        const char *incompleteNote = nullptr;     // logged with the buffer size while nothing matches
+
+        // Filled when the table is built: responses (indexes, in table order) by the first byte of their prefix,
+        // and the suffix only (EndsWith) ones, so a match only compares the few sharing the buffer's first byte
+        QVector<int> byFirstByte[256];
+        QVector<int> suffixOnly;
+    };
+
+    // nullptr when the msgId is unknown
+    const Command *command(quint8 msgId);
+
+    // First response of the command the buffer matches, nullptr when none does
+    // Looked up by the buffer's first byte, a Frame match only needs the prefix (the caller looks for the footer).
+    const Response *match(const Command &command, const QByteArray &buffer);
+}
+
+#endif // PROTOCOLTABLE_H
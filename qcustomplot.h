@@ -2640,6 +2640,11 @@ public:
   void sort();
   void squeeze(bool preAllocation=true, bool postAllocation=true);
   
+  // streaming (sliding window) fast path:
+  void reserveStreaming(int capacity);
+  iterator appendSorted(int n);
+  void removeFront(int n);
+  
   const_iterator constBegin() const { return mData.constBegin()+mPreallocSize; }
   const_iterator constEnd() const { return mData.constEnd(); }
   iterator begin() { return mData.begin()+mPreallocSize; }
@@ -3086,6 +3091,63 @@ void QCPDataContainer<DataType>::squeeze(bool preAllocation, bool postAllocation
     mData.squeeze();
 }
 
+/*!
+  Prepares the container for streaming use with \ref appendSorted and \ref removeFront: Automatic
+  squeezing is disabled and storage for \a capacity data points is reserved, so a sliding window of
+  up to about half of \a capacity data points can be maintained without any further allocation.
+  
+  \see appendSorted, removeFront
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::reserveStreaming(int capacity)
+{
+  mAutoSqueeze = false;
+  if (mData.capacity() < capacity)
+  {
+    squeeze(true, false);
+    mData.reserve(capacity);
+  }
+}
+
+/*!
+  Appends \a n default constructed data points to the end of the container and returns an iterator
+  to the first of them, for the caller to fill in. The caller must guarantee that the (sort-)keys
+  written are ascending and not smaller than the last existing key, no sorting or merging is done.
+  
+  Space freed at the front by \ref removeFront or \ref removeBefore is reused (the remaining data is
+  moved to the start of the storage) before the storage is grown. With storage reserved by \ref
+  reserveStreaming, appending thus never allocates.
+  
+  \see removeFront
+*/
+template <class DataType>
+typename QCPDataContainer<DataType>::iterator QCPDataContainer<DataType>::appendSorted(int n)
+{
+  if (n <= 0)
+    return end();
+  if (mPreallocSize > 0 && mData.size()+n > mData.capacity())
+  {
+    std::copy(begin(), end(), mData.begin());
+    mData.resize(size());
+    mPreallocSize = 0;
+    mPreallocIteration = 0;
+  }
+  mData.resize(mData.size()+n);
+  return end()-n;
+}
+
+/*!
+  Removes the first \a n data points in constant time. Their storage becomes part of the
+  preallocation pool, which \ref appendSorted reuses. Unlike \ref removeBefore, this never squeezes.
+  
+  \see appendSorted
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::removeFront(int n)
+{
+  mPreallocSize += qBound(0, n, size());
+}
+
 /*!
   Returns an iterator to the data point with a (sort-)key that is equal to, just below, or just
   above \a sortKey. If \a expandedRange is true, the data point just below \a sortKey will be
@@ -0,0 +1,81 @@
+#include "rawconsole.h"
+
+RawConsole::RawConsole(QWidget *parent)
+    : QPlainTextEdit(parent)
+{
+    setReadOnly(true);
+    setUndoRedoEnabled(false);
+    setMaximumBlockCount(mMaxLines);
+
+    // Started by the first queued line, idle costs nothing
+    mFlushTimer.setSingleShot(true);
+    mFlushTimer.setInterval(DEFAULT_FLUSH_INTERVAL_MS);
+    connect(&mFlushTimer, &QTimer::timeout, this, &RawConsole::flush);
+}
+
+void RawConsole::setMaxLines(int lines)
+{
+    mMaxLines = qMax(1, lines);
+    setMaximumBlockCount(mMaxLines);
+}
+
+void RawConsole::setFlushInterval(int ms)
+{
+    mFlushTimer.setInterval(qMax(0, ms));
+}
+
+void RawConsole::appendLine(const QString &line)
+{
+    if (line == mLastLine && !mLastLine.isEmpty())
+    {
+        // Counted only, the count is written by the next different line or the next tick
+        mRepeats++;
+        if (!mFlushTimer.isActive())
+            mFlushTimer.start();
+        return;
+    }
+
+    queueRepeats();
+    mLastLine = line;
+    mPending.append(line);
+
+    // More than the document can show before the next tick, the oldest would only be trimmed again
+    while (mPending.size() > mMaxLines)
+    {
+        mPending.removeFirst();
+        mDropped++;
+    }
+
+    if (!mFlushTimer.isActive())
+        mFlushTimer.start();
+}
+
+void RawConsole::flush()
+{
+    // mLastLine is kept, further copies keep collapsing into the next count
+    queueRepeats();
+    if (mPending.isEmpty())
+        return;
+
+    // One block insert for the whole batch, the view follows the end only if it was already there
+    appendPlainText(mPending.join('\n'));
+    mPending.clear();
+}
+
+void RawConsole::queueRepeats()
+{
+    if (mRepeats == 0)
+        return;
+
+    mPending.append(QString("    ... repeated %1 more times").arg(mRepeats));
+    mRepeats = 0;
+}
+
+void RawConsole::clearConsole()
+{
+    mFlushTimer.stop();
+    mPending.clear();
+    mLastLine.clear();
+    mRepeats = 0;
+    clear();
+}
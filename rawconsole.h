@@ -0,0 +1,46 @@
+#ifndef RAWCONSOLE_H
+#define RAWCONSOLE_H
+
+#include <QPlainTextEdit>
+#include <QStringList>
+#include <QTimer>
+
+// Port status / raw bytes console, bounded whatever the capture length
+// Lines are queued and written once per flush interval as plain text (one layout per tick instead of one per
+// line), repeated lines in a row collapse into one with a count, and the document keeps at most maxLines
+// lines (older ones are dropped from the top, no undo history)
+class RawConsole : public QPlainTextEdit
+{
+    Q_OBJECT
+
+public:
+    static const int DEFAULT_MAX_LINES = 2000;
+    static const int DEFAULT_FLUSH_INTERVAL_MS = 100;
+
+    explicit RawConsole(QWidget *parent = nullptr);
+
+    void setMaxLines(int lines);
+    int maxLines() const { return mMaxLines; }
+
+    void setFlushInterval(int ms);
+    int flushInterval() const { return mFlushTimer.interval(); }
+
+    qint64 droppedLines() const { return mDropped; }
+
+public slots:
+    void appendLine(const QString &line);
+    void flush();
+    void clearConsole();
+
+private:
+    void queueRepeats();
+
+    QStringList mPending;
+    QString mLastLine;          // last line queued, for collapsing repeats
+    int mRepeats = 0;           // further copies of mLastLine not written yet
+    int mMaxLines = DEFAULT_MAX_LINES;
+    qint64 mDropped = 0;        // queued lines that never reached the document (more than maxLines per tick)
+    QTimer mFlushTimer;
+};
+
+#endif // RAWCONSOLE_H
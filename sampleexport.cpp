@@ -0,0 +1,498 @@
+#include "sampleexport.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QStack>
+#include <QThread>
+#include <QThreadPool>
+
+#include <QtZlib/zlib.h>
+
+#include "xlsxutility_p.h"      // QXlsx::doubleToChars, shortest round trip text
+
+namespace
+{
+    const int CSV_FLUSH_BYTES = 1 << 20;
+
+    // ---- Parquet constants (parquet.thrift) ----
+    const char PARQUET_MAGIC[4] = { 'P', 'A', 'R', '1' };
+    const int TYPE_DOUBLE = 5;
+    const int REPETITION_OPTIONAL = 1;
+    const int ENCODING_PLAIN = 0;
+    const int ENCODING_RLE = 3;
+    const int CODEC_GZIP = 2;
+    const int PAGE_DATA = 0;
+
+    // ---- Thrift compact protocol, just what the Parquet footer / page headers need ----
+    class ThriftWriter
+    {
+    public:
+        enum Type { I32 = 5, I64 = 6, BINARY = 8, LIST = 9, STRUCT = 12 };
+
+        QByteArray out;
+
+        void beginStruct() { mFieldStack.push(mLastField); mLastField = 0; }
+        void endStruct() { out.append(char(0)); mLastField = mFieldStack.pop(); }
+
+        void i32(int id, qint32 value) { field(id, I32); varint(zigzag(value)); }
+        void i64(int id, qint64 value) { field(id, I64); varint(zigzag(value)); }
+        void string(int id, const QByteArray &value) { field(id, BINARY); listString(value); }
+        void structField(int id) { field(id, STRUCT); beginStruct(); }
+
+        // Elements follow without field headers (listI32 / listString / beginStruct per element)
+        void list(int id, Type elementType, int size)
+        {
+            field(id, LIST);
+            if (size < 15)
+            {
+                out.append(char((size << 4) | elementType));
+            }
+            else
+            {
+                out.append(char(0xF0 | elementType));
+                varint(quint64(size));
+            }
+        }
+        void listI32(qint32 value) { varint(zigzag(value)); }
+        void listString(const QByteArray &value) { varint(quint64(value.size())); out.append(value); }
+
+    private:
+        void field(int id, int type)
+        {
+            const int delta = id - mLastField;
+            if (delta > 0 && delta <= 15)
+            {
+                out.append(char((delta << 4) | type));
+            }
+            else
+            {
+                out.append(char(type));
+                varint(zigzag(qint32(id)));
+            }
+            mLastField = id;
+        }
+
+        static quint64 zigzag(qint64 value) { return (quint64(value) << 1) ^ quint64(value >> 63); }
+
+        void varint(quint64 value)
+        {
+            while (value >= 0x80)
+            {
+                out.append(char((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            out.append(char(value));
+        }
+
+        int mLastField = 0;
+        QStack<int> mFieldStack;
+    };
+
+    void appendVarint(QByteArray &out, quint32 value)
+    {
+        while (value >= 0x80)
+        {
+            out.append(char((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.append(char(value));
+    }
+
+    // One column chunk (= one data page) of a row group, compressed on a pool thread
+    struct ColumnPage
+    {
+        const double *data = nullptr;
+        int rows = 0;           // rows in the row group
+        int present = 0;        // leading rows that have a value, the rest are null
+
+        qint64 uncompressedSize = 0;
+        QByteArray compressed;
+        bool ok = false;
+    };
+
+    // Definition levels of an OPTIONAL column (RLE/bit-packed hybrid, bit width 1, 4 byte length prefix)
+    QByteArray definitionLevels(int present, int rows)
+    {
+        QByteArray runs;
+        if (present > 0)
+        {
+            appendVarint(runs, quint32(present) << 1);
+            runs.append(char(1));
+        }
+        if (rows - present > 0)
+        {
+            appendVarint(runs, quint32(rows - present) << 1);
+            runs.append(char(0));
+        }
+
+        QByteArray levels;
+        const quint32 length = quint32(runs.size());
+        for (int i = 0; i < 4; ++i)
+            levels.append(char((length >> (8 * i)) & 0xFF));
+        levels.append(runs);
+        return levels;
+    }
+
+    void compressPage(ColumnPage &page)
+    {
+        const QByteArray levels = definitionLevels(page.present, page.rows);
+        const qint64 valueBytes = qint64(page.present) * qint64(sizeof(double));
+        page.uncompressedSize = levels.size() + valueBytes;
+
+        // gzip wrapper (windowBits 15 + 16), what the Parquet GZIP codec expects
+        z_stream zs = {};
+        if (deflateInit2(&zs, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return;
+
+        page.compressed.resize(int(deflateBound(&zs, uLong(page.uncompressedSize))) + 64);
+        zs.next_out = reinterpret_cast<Bytef *>(page.compressed.data());
+        zs.avail_out = uInt(page.compressed.size());
+
+        zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(levels.constData()));
+        zs.avail_in = uInt(levels.size());
+        int rc = deflate(&zs, Z_NO_FLUSH);
+
+        if (rc == Z_OK)
+        {
+            // Little-endian host assumed (x86 / ARM), PLAIN doubles are the raw IEEE bytes
+            zs.next_in = reinterpret_cast<Bytef *>(const_cast<double *>(page.data));
+            zs.avail_in = uInt(valueBytes);
+            rc = deflate(&zs, Z_FINISH);
+        }
+
+        page.ok = (rc == Z_STREAM_END);
+        page.compressed.resize(page.ok ? int(zs.total_out) : 0);
+        deflateEnd(&zs);
+    }
+
+    class PageTask : public QRunnable
+    {
+    public:
+        explicit PageTask(ColumnPage *page) : mPage(page) {}
+        void run() override { compressPage(*mPage); }
+
+    private:
+        ColumnPage *mPage;
+    };
+
+    struct ChunkInfo
+    {
+        qint64 offset = 0;
+        qint64 uncompressedSize = 0;    // including the page header
+        qint64 compressedSize = 0;
+    };
+
+    struct RowGroupInfo
+    {
+        int rows = 0;
+        QVector<ChunkInfo> chunks;
+    };
+
+    QByteArray pageHeader(const ColumnPage &page)
+    {
+        ThriftWriter w;
+        w.beginStruct();
+        w.i32(1, PAGE_DATA);
+        w.i32(2, qint32(page.uncompressedSize));
+        w.i32(3, page.compressed.size());
+        w.structField(5);                       // DataPageHeader
+        w.i32(1, page.rows);
+        w.i32(2, ENCODING_PLAIN);
+        w.i32(3, ENCODING_RLE);                 // definition levels
+        w.i32(4, ENCODING_RLE);                 // repetition levels (none)
+        w.endStruct();
+        w.endStruct();
+        return w.out;
+    }
+
+    QByteArray fileFooter(const QVector<SampleExport::Column> &columns,
+                          const QVector<RowGroupInfo> &rowGroups,
+                          qint64 totalRows,
+                          const SampleExport::Metadata &metadata)
+    {
+        ThriftWriter w;
+        w.beginStruct();
+        w.i32(1, 1);                            // version
+
+        // ---- Schema: root + one OPTIONAL DOUBLE per column ----
+        w.list(2, ThriftWriter::STRUCT, columns.size() + 1);
+        w.beginStruct();
+        w.string(4, "schema");
+        w.i32(5, columns.size());
+        w.endStruct();
+        for (const SampleExport::Column &column : columns)
+        {
+            w.beginStruct();
+            w.i32(1, TYPE_DOUBLE);
+            w.i32(3, REPETITION_OPTIONAL);
+            w.string(4, column.name.toUtf8());
+            w.endStruct();
+        }
+
+        w.i64(3, totalRows);
+
+        // ---- Row groups ----
+        w.list(4, ThriftWriter::STRUCT, rowGroups.size());
+        for (const RowGroupInfo &group : rowGroups)
+        {
+            qint64 groupBytes = 0;
+            w.beginStruct();
+            w.list(1, ThriftWriter::STRUCT, columns.size());
+            for (int c = 0; c < columns.size(); ++c)
+            {
+                const ChunkInfo &chunk = group.chunks[c];
+                groupBytes += chunk.uncompressedSize;
+
+                w.beginStruct();                // ColumnChunk
+                w.i64(2, chunk.offset);
+                w.structField(3);               // ColumnMetaData
+                w.i32(1, TYPE_DOUBLE);
+                w.list(2, ThriftWriter::I32, 2);
+                w.listI32(ENCODING_PLAIN);
+                w.listI32(ENCODING_RLE);
+                w.list(3, ThriftWriter::BINARY, 1);
+                w.listString(columns[c].name.toUtf8());
+                w.i32(4, CODEC_GZIP);
+                w.i64(5, group.rows);
+                w.i64(6, chunk.uncompressedSize);
+                w.i64(7, chunk.compressedSize);
+                w.i64(9, chunk.offset);         // data_page_offset
+                w.endStruct();
+                w.endStruct();
+            }
+            w.i64(2, groupBytes);
+            w.i64(3, group.rows);
+            w.endStruct();
+        }
+
+        // ---- Event id, frequencies, ... ----
+        if (!metadata.isEmpty())
+        {
+            w.list(5, ThriftWriter::STRUCT, metadata.size());
+            for (const auto &entry : metadata)
+            {
+                w.beginStruct();
+                w.string(1, entry.first.toUtf8());
+                w.string(2, entry.second.toUtf8());
+                w.endStruct();
+            }
+        }
+
+        w.string(6, "Envirologger");
+        w.endStruct();
+        return w.out;
+    }
+
+    int rowCount(const QVector<SampleExport::Column> &columns)
+    {
+        int rows = 0;
+        for (const SampleExport::Column &column : columns)
+            rows = qMax(rows, column.data ? column.count : 0);
+        return rows;
+    }
+
+    QByteArray csvField(const QString &text)
+    {
+        QByteArray field = text.toUtf8();
+        if (field.contains(',') || field.contains('"') || field.contains('\n'))
+            field = '"' + field.replace("\"", "\"\"") + '"';
+        return field;
+    }
+
+    void setError(QString *error, const QString &text)
+    {
+        qDebug() << "SampleExport:" << text;
+        if (error)
+            *error = text;
+    }
+}
+
+QString SampleExport::fileFilter()
+{
+    return "Excel Files (*.xlsx);;CSV Files (*.csv);;Parquet Files (*.parquet)";
+}
+
+SampleExport::Format SampleExport::formatFor(const QString &fileName, const QString &selectedFilter)
+{
+    const QString ext = QFileInfo(fileName).suffix().toLower();
+    if (ext == "csv") return Format::Csv;
+    if (ext == "parquet") return Format::Parquet;
+    if (ext == "xlsx") return Format::Xlsx;
+
+    if (selectedFilter.contains("*.csv")) return Format::Csv;
+    if (selectedFilter.contains("*.parquet")) return Format::Parquet;
+    return Format::Xlsx;
+}
+
+QString SampleExport::suffix(Format format)
+{
+    switch (format)
+    {
+    case Format::Csv:     return ".csv";
+    case Format::Parquet: return ".parquet";
+    default:              return ".xlsx";
+    }
+}
+
+bool SampleExport::writeCsv(const QString &fileName, const QVector<Column> &columns,
+                            const Metadata &metadata, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        setError(error, file.errorString());
+        return false;
+    }
+
+    QByteArray buffer;
+    buffer.reserve(CSV_FLUSH_BYTES + 4096);
+
+    // ---- Metadata lines and header ----
+    for (const auto &entry : metadata)
+        buffer += "# " + entry.first.toUtf8() + ": " + entry.second.toUtf8() + "\n";
+
+    for (int c = 0; c < columns.size(); ++c)
+    {
+        if (c) buffer += ',';
+        buffer += csvField(columns[c].name);
+    }
+    buffer += '\n';
+
+    // ---- Rows, formatted into one buffer and written in ~1 MiB blocks ----
+    const int rows = rowCount(columns);
+    char number[QXlsx::NumberBufferSize];
+
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int c = 0; c < columns.size(); ++c)
+        {
+            if (c) buffer += ',';
+            const Column &column = columns[c];
+            if (column.data && row < column.count)
+                buffer.append(number, QXlsx::doubleToChars(column.data[row], number));
+        }
+        buffer += '\n';
+
+        if (buffer.size() >= CSV_FLUSH_BYTES)
+        {
+            if (file.write(buffer) != buffer.size())
+            {
+                setError(error, file.errorString());
+                return false;
+            }
+            buffer.clear();
+        }
+    }
+
+    if (file.write(buffer) != buffer.size() || !file.flush())
+    {
+        setError(error, file.errorString());
+        return false;
+    }
+
+    qDebug() << "CSV export:" << rows << "rows," << columns.size() << "columns to" << fileName;
+    return true;
+}
+
+bool SampleExport::writeParquet(const QString &fileName, const QVector<Column> &columns,
+                                const Metadata &metadata, QString *error)
+{
+    if (columns.isEmpty())
+    {
+        setError(error, "No columns to export");
+        return false;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        setError(error, file.errorString());
+        return false;
+    }
+
+    const int totalRows = rowCount(columns);
+    qint64 offset = 0;
+
+    auto writeBytes = [&](const char *data, qint64 size)
+    {
+        if (file.write(data, size) != size)
+            return false;
+        offset += size;
+        return true;
+    };
+
+    if (!writeBytes(PARQUET_MAGIC, 4))
+    {
+        setError(error, file.errorString());
+        return false;
+    }
+
+    // Column pages of one row group are compressed in parallel, written in column order
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, qMin(QThread::idealThreadCount(), columns.size())));
+
+    QVector<RowGroupInfo> rowGroups;
+    for (int start = 0; start < totalRows; start += ROWS_PER_ROW_GROUP)
+    {
+        RowGroupInfo group;
+        group.rows = qMin(ROWS_PER_ROW_GROUP, totalRows - start);
+
+        QVector<ColumnPage> pages(columns.size());
+        for (int c = 0; c < columns.size(); ++c)
+        {
+            ColumnPage &page = pages[c];
+            page.rows = group.rows;
+            page.present = columns[c].data ? qBound(0, columns[c].count - start, group.rows) : 0;
+            page.data = page.present > 0 ? columns[c].data + start : nullptr;
+
+            PageTask *task = new PageTask(&page);
+            task->setAutoDelete(true);
+            pool.start(task);
+        }
+        pool.waitForDone();
+
+        for (const ColumnPage &page : qAsConst(pages))
+        {
+            if (!page.ok)
+            {
+                setError(error, "Compression failed");
+                return false;
+            }
+
+            const QByteArray header = pageHeader(page);
+            ChunkInfo chunk;
+            chunk.offset = offset;
+            chunk.uncompressedSize = header.size() + page.uncompressedSize;
+            chunk.compressedSize = header.size() + page.compressed.size();
+
+            if (!writeBytes(header.constData(), header.size())
+                    || !writeBytes(page.compressed.constData(), page.compressed.size()))
+            {
+                setError(error, file.errorString());
+                return false;
+            }
+            group.chunks.append(chunk);
+        }
+        rowGroups.append(group);
+    }
+
+    // ---- Footer: FileMetaData, its length, magic ----
+    const QByteArray footer = fileFooter(columns, rowGroups, totalRows, metadata);
+    const quint32 footerLength = quint32(footer.size());
+    char lengthBytes[4];
+    for (int i = 0; i < 4; ++i)
+        lengthBytes[i] = char((footerLength >> (8 * i)) & 0xFF);
+
+    if (!writeBytes(footer.constData(), footer.size()) || !writeBytes(lengthBytes, 4)
+            || !writeBytes(PARQUET_MAGIC, 4) || !file.flush())
+    {
+        setError(error, file.errorString());
+        return false;
+    }
+
+    qDebug() << "Parquet export:" << totalRows << "rows," << columns.size() << "columns,"
+             << rowGroups.size() << "row groups," << offset << "bytes to" << fileName;
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef SAMPLEEXPORT_H
+#define SAMPLEEXPORT_H
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+// Streaming CSV / Parquet export straight from the sample vectors (no QXlsx::Document)
+//
+//   CSV      "# key: value" metadata lines, one header row, then one row per sample index,
+//            columns shorter than the longest one leave their fields empty
+//   Parquet  one OPTIONAL DOUBLE column per sensor channel (missing tail values are null),
+//            PLAIN encoding, GZIP pages, row groups of ROWS_PER_ROW_GROUP samples,
+//            metadata in the footer key/value list (pandas.read_parquet / pyarrow read it directly)
+namespace SampleExport
+{
+    const int ROWS_PER_ROW_GROUP = 1 << 20;
+
+    enum class Format
+    {
+        Xlsx,
+        Csv,
+        Parquet
+    };
+
+    // One named column, points into the caller's buffer (not copied)
+    struct Column
+    {
+        QString name;
+        const double *data = nullptr;
+        int count = 0;
+
+        Column() {}
+        Column(const QString &name, const double *data, int count)
+            : name(name), data(data), count(count) {}
+        Column(const QString &name, const QVector<double> &values)
+            : name(name), data(values.constData()), count(values.size()) {}
+    };
+
+    typedef QList<QPair<QString, QString>> Metadata;
+
+    // QFileDialog filter list and the format picked from it / from the file suffix
+    QString fileFilter();
+    Format formatFor(const QString &fileName, const QString &selectedFilter);
+    QString suffix(Format format);
+
+    bool writeCsv(const QString &fileName, const QVector<Column> &columns,
+                  const Metadata &metadata, QString *error = nullptr);
+    bool writeParquet(const QString &fileName, const QVector<Column> &columns,
+                      const Metadata &metadata, QString *error = nullptr);
+}
+
+#endif // SAMPLEEXPORT_H
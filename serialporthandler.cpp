@@ -1,5 +1,10 @@
 #include "serialporthandler.h"
 
+namespace
+{
+    const int EVENT_PROGRESS_INTERVAL_MS = 100;
+}
+
 serialPortHandler::serialPortHandler(QObject *parent) : QObject(parent)
 {
     serial = new QSerialPort;
@@ -102,11 +107,93 @@ QString serialPortHandler::hexBytesSerial(QByteArray &cmd)
     //**************************Visuals*******************
 }
 
+void serialPortHandler::writeHexToNotes(LogLevel level, const QString &label, const QByteArray &bytes)
+{
+    // Hex formatting triples the packet size, only pay for it when the level is enabled
+    AsyncLogger &logger = AsyncLogger::instance();
+    if (logger.isEnabled(level))
+        logger.log(level, label + bytes.toHex(' ').toUpper());
+}
+
+void serialPortHandler::setReceiveLogMode(ReceiveLogMode mode, int sampleBytes)
+{
+    receiveLogMode = mode;
+    receiveSampleBytes = qMax(0, sampleBytes);
+}
+
+ReceiveLogMode serialPortHandler::receiveLogModeFromString(const QString &name, ReceiveLogMode fallback)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == "off")     return ReceiveLogMode::Off;
+    if (key == "summary") return ReceiveLogMode::Summary;
+    if (key == "chunks")  return ReceiveLogMode::Chunks;
+    if (key == "hex")     return ReceiveLogMode::Hex;
+    return fallback;
+}
+
+void serialPortHandler::logReceivedChunk(const QByteArray &chunk)
+{
+    // ---- Counters (cheap, always kept) ----
+    const qint64 offset = receiveStats.bytes;
+    if (receiveStats.chunks == 0)
+    {
+        receiveStats.msgId = id;
+        receiveStats.minChunk = chunk.size();
+        receiveStats.elapsed.start();
+    }
+    receiveStats.chunks++;
+    receiveStats.bytes += chunk.size();
+    receiveStats.minChunk = qMin(receiveStats.minChunk, chunk.size());
+    receiveStats.maxChunk = qMax(receiveStats.maxChunk, chunk.size());
+
+    AsyncLogger &logger = AsyncLogger::instance();
+    if (receiveLogMode < ReceiveLogMode::Chunks || !logger.isEnabled(LogLevel::Info))
+        return;
+
+    // ---- Only the new chunk, so the cost stays linear in the bytes received ----
+    QString line = QString("data Received: chunk %1 len %2 offset %3")
+            .arg(receiveStats.chunks).arg(chunk.size()).arg(offset);
+
+    if (receiveLogMode == ReceiveLogMode::Hex)
+    {
+        line += " : " + chunk.toHex(' ').toUpper();
+    }
+    else if (receiveSampleBytes > 0)
+    {
+        line += " head " + chunk.left(receiveSampleBytes).toHex(' ').toUpper();
+        if (chunk.size() > receiveSampleBytes)
+            line += " tail " + chunk.right(qMin(receiveSampleBytes, chunk.size() - receiveSampleBytes)).toHex(' ').toUpper();
+    }
+
+    logger.log(LogLevel::Info, line);
+}
+
+void serialPortHandler::logReceiveSummary()
+{
+    if (receiveStats.chunks == 0)
+        return;
+
+    if (receiveLogMode != ReceiveLogMode::Off)
+    {
+        const double seconds = receiveStats.elapsed.nsecsElapsed() / 1e9;
+        executeWriteToNotes(QString("Receive summary msgId 0x%1: %2 bytes in %3 chunks (min %4, max %5, avg %6), %7 s, %8 KB/s")
+                            .arg(receiveStats.msgId, 2, 16, QChar('0'))
+                            .arg(receiveStats.bytes)
+                            .arg(receiveStats.chunks)
+                            .arg(receiveStats.minChunk)
+                            .arg(receiveStats.maxChunk)
+                            .arg(receiveStats.bytes / receiveStats.chunks)
+                            .arg(seconds, 0, 'f', 3)
+                            .arg(seconds > 0 ? receiveStats.bytes / 1024.0 / seconds : 0.0, 0, 'f', 1));
+    }
+
+    receiveStats = ReceiveStats();
+}
+
 void serialPortHandler::readData()
 {
     qDebug()<<"------------------------------------------------------------------------------------";
     emit portOpening("------------------------------------------------------------------------------------");
-    QByteArray ResponseData;
     // Read data from the serial port
     if (serial->bytesAvailable() == 0)
     {
@@ -117,14 +204,27 @@ void serialPortHandler::readData()
     // Create a QMutexLocker to manage the mutex
     QMutexLocker locker(&bufferMutex); // Lock the mutex
 
+    // ---- Table lookup of the command the device is answering ----
+    const ProtocolTable::Command *command = ProtocolTable::command(id);
 
+    QByteArray chunk;
     if (serial->bytesAvailable() < std::numeric_limits<int>::max())
     {
-        buffer.append(serial->readAll()); // Append only if it won't exceed max size
-        if (!buffer.isEmpty())
+        chunk = serial->readAll();
+        AsyncLogger::instance().trace(TraceEvent::DataReceived, chunk);
+
+        // Event data is parsed chunk by chunk below, nothing accumulates
+        if (!command || command->handling != ProtocolTable::Handling::Event)
+            buffer.append(chunk); // Append only if it won't exceed max size
+
+        if (!chunk.isEmpty())
         {
             emit dataReceived();
-            executeWriteToNotes("data Received:"+buffer.toHex());
+            logReceivedChunk(chunk);
+        }
+        else
+        {
+            return;
         }
     }
     else
@@ -133,498 +233,199 @@ void serialPortHandler::readData()
         return;
     }
 
-
-    //Direct taking msgId from mainWindow
-    quint8 msgId = id;
-
-    //powerId to avoid that warning QByteRef calling out of bond error
-    quint8 powerId = 0x00;
-
-
-   // qDebug()<<buffer.toHex()<<" data Received";
-    if(msgId == 0x01)
+    if (!command)
     {
-        qDebug()<<buffer.size()<<" :size";
-    }
-    else
-    {
-      //  qDebug()<<buffer.toHex()<<" Raw buffer data";
-        qDebug()<<buffer.size()<<" :size";
+        executeWriteToNotes("unknowm msg id");
+        return;
     }
 
-
-    if(msgId == 0x01)
-    {
-        qDebug() << "msgId:" <<hex<<msgId;
-
-        if(buffer.startsWith(QByteArray::fromHex("AA BB")) && buffer.endsWith(QByteArray::fromHex("AA BB CC DD FF")))
-        {
-            powerId = 0x01;
-            ResponseData = buffer;
-            buffer.clear();
-            executeWriteToNotes("Get Event data size: "+QString::number(ResponseData.size()));
-            executeWriteToNotes("Get Event Data cmd received bytes: "+ResponseData.toHex(' ').toUpper());
-        }
-        else if(buffer == QByteArray::fromHex("53 54 45 FF"))
-        {
-            powerId = 0x01;
-            ResponseData = buffer;
-            buffer.clear();
-            executeWriteToNotes("Get Event Data cmd received bytes [NACK Condition]: "+ResponseData.toHex(' ').toUpper());
-        }
-        else
-        {
-            executeWriteToNotes("Required AA BB as header and AA BB CC DD FF as footer, bytes Received bytes: "+QString::number(buffer.size()));
-        }
-
-    }
-    else if (msgId == 0x02)
+    switch (command->handling)
     {
-        if (buffer.isEmpty())
-            return;
-
-        const QByteArray START_LOG_INIT = QByteArray::fromHex("54 53 41 43 4B");
-        const QByteArray START_LOG_END  = QByteArray::fromHex("54 53 50");
-
-        const QByteArray LIVE_HEADER = QByteArray::fromHex("AA BB");
-        const QByteArray LIVE_FOOTER = QByteArray::fromHex("FF FF");
-
-        const QByteArray ADXL_HEADER = QByteArray::fromHex("CC DD FF");
-        const QByteArray ADXL_FOOTER = QByteArray::fromHex("EE FF");
-
-        const QByteArray INCL_HEADER = QByteArray::fromHex("EE FF FF");
-        const QByteArray INCL_FOOTER = QByteArray::fromHex("CC DD");
-
-        // ---------------- START LOG INIT ----------------
-        if (buffer.startsWith(START_LOG_INIT))
-        {
-            ResponseData = START_LOG_INIT;
-            buffer.remove(0, START_LOG_INIT.size());
-            powerId = 0x02;
-
-            executeWriteToNotes("Start Log Initial cmd received");
-
-        }
-
-        // ---------------- START LOG END ----------------
-        else if (buffer.startsWith(START_LOG_END))
-        {
-            ResponseData = START_LOG_END;
-            buffer.remove(0, START_LOG_END.size());
-            powerId = 0x02;
-
-            executeWriteToNotes("Start Log End cmd received");
-
-        }
-
-        // ---------------- LIVE FREQ PACKET ----------------
-        else if (buffer.startsWith(LIVE_HEADER))
-        {
-            int footerPos = buffer.indexOf(LIVE_FOOTER, LIVE_HEADER.size());
-            if (footerPos < 0) return;   // WAIT FOR FULL PACKET
-
-            int packetSize = footerPos + LIVE_FOOTER.size();
-            ResponseData = buffer.left(packetSize);
-            buffer.remove(0, packetSize);
-            powerId = 0x13;
-
-            executeWriteToNotes("Live Frequency Packet: size = "
-                                + QString::number(ResponseData.size()));
-
-
-        }
-
-        // ---------------- ADXL PACKET ----------------
-        else if (buffer.startsWith(ADXL_HEADER))
-        {
-            int footerPos = buffer.indexOf(ADXL_FOOTER, ADXL_HEADER.size());
-            if (footerPos < 0) return;  // WAIT FOR FULL PACKET
-
-            int packetSize = footerPos + ADXL_FOOTER.size();
-            ResponseData = buffer.left(packetSize);
-            buffer.remove(0, packetSize);
-            adxlPackets++;
-            powerId = 0x13;
-
-            executeWriteToNotes("ADXL Packet: size = "
-                                + QString::number(ResponseData.size()));
-            executeWriteToNotes("ADXL Packet:"
-                                + ResponseData.toHex(' ').toUpper());
-
-
-        }
-
-        // ---------------- INCL PACKET ----------------
-       else if (buffer.startsWith(INCL_HEADER))
-        {
-            int footerPos = buffer.indexOf(INCL_FOOTER, INCL_HEADER.size());
-            if (footerPos < 0) return;  // WAIT FOR FULL PACKET
-
-            int packetSize = footerPos + INCL_FOOTER.size();
-            ResponseData = buffer.left(packetSize);
-            buffer.remove(0, packetSize);
-            inclPackets++;
-            powerId = 0x13;
-
-            executeWriteToNotes("Incl Packet: size = "
-                                + QString::number(ResponseData.size()));
-            executeWriteToNotes("ADXL Packet:"
-                                + ResponseData.toHex(' ').toUpper());
-
-
-        }
-        else{
-            executeWriteToNotes("The Packet:"
-                                + buffer.toHex(' ').toUpper());
-            executeWriteToNotes("Live Data with Invalid Header");
-            buffer.clear();
-
-
-        }
-
-    }
+    case ProtocolTable::Handling::Event:
+        readEventChunk(chunk);
+        break;
 
-    else if(msgId == 0x03)
+    case ProtocolTable::Handling::Live:
     {
-        qDebug() << "" <<hex<<msgId;
-
-        if(buffer.startsWith(QByteArray::fromHex("AA BB")) && buffer.endsWith(QByteArray::fromHex("65 6E 64 FF EF EE")))
-        {
-            powerId = 0x03;
-            ResponseData = buffer;
-            buffer.clear();
-            executeWriteToNotes("Get Log Events cmd received bytes: "+ResponseData.toHex(' ').toUpper());
-        }
-        else
-        {
-            executeWriteToNotes("Required  bytes with header AA BB and footer 65 6E 64 FF EF EE, bytes Received bytes: "+QString::number(buffer.size()));
-        }
+        // Every complete frame in the buffer, not just the first one; frames are handed over in place and
+        // the consumed bytes are dropped once per read
+        int offset = 0;
+        while (dispatchLiveFrame(*command, offset))
+            ;
+        buffer.remove(0, qMin(offset, buffer.size()));
+        break;
     }
-    else if(msgId == 0x04)
-    {
-        qDebug() << "" <<hex<<msgId;
 
-        if(buffer == QByteArray::fromHex("53 54 46"))
-        {
-            powerId = 0x04;
-            ResponseData = buffer;
-            buffer.clear();
-            executeWriteToNotes("Stop Plot cmd received bytes: "+ResponseData.toHex(' ').toUpper());
-        }
-        else
-        {
-            executeWriteToNotes("Required 3, bytes Received bytes: "+QString::number(buffer.size()));
-        }
+    case ProtocolTable::Handling::Framed:
+        dispatchFramed(*command);
+        break;
     }
-    else if(msgId == 0x05){
-        qDebug() << "" <<hex<<msgId;
-
-        if(buffer.startsWith(QByteArray::fromHex("53 54 54")))
-        {
-            powerId = 0x05;
-            ResponseData = buffer;
-            buffer.clear();
-            executeWriteToNotes("Remaining cmd received bytes: "+ResponseData.toHex(' ').toUpper());
-        }
-        else
-        {
-            executeWriteToNotes("Required 3, bytes Received bytes: "+QString::number(buffer.size()));
-        }
+}
 
-    }
-    else if(msgId ==0x06){
-          qDebug() << "" <<hex<<msgId;
-        if(buffer.startsWith(QByteArray::fromHex("53 54 55"))){
-            powerId = 0x06;
-            ResponseData = buffer;
-            buffer.clear();
-            executeWriteToNotes("System on Data cmd received bytes: "+ResponseData.toHex(' ').toUpper());
+void serialPortHandler::readEventChunk(const QByteArray &chunk)
+{
+    qDebug() << "msgId:" << hex << id;
 
-        }
-        else{
-            executeWriteToNotes("Required 3, bytes Received bytes: "+QString::number(buffer.size()));
-        }
+    const EventStreamParser::State state = eventParser.feed(chunk);
+    const EventStreamParser::Event &event = eventParser.event();
+    qDebug() << event.bytes << " :size";
 
-    }
-    else if(msgId==0x07){
-        qDebug()<<"msg Id:"<<hex<<msgId;
-        if(buffer.startsWith(QByteArray::fromHex("54 53 41 43 4C"))){
-            powerId=0x07;
-            ResponseData=buffer;
-            buffer.clear();
-            executeWriteToNotes("Erase command Received bytes:"+ResponseData.toHex(' ').toUpper());
-        }
-        else if(buffer==(QByteArray::fromHex("54 53 44 4F 4E 45"))){
-            powerId=0x07;
-            ResponseData=buffer;
-            buffer.clear();
-            executeWriteToNotes("Erase command Received bytes:"+ResponseData.toHex(' ').toUpper());
+    if (state == EventStreamParser::State::Complete)
+    {
+        executeWriteToNotes("Get Event data size: " + QString::number(event.bytes));
+        emit eventProgress(event.bytes, event.adxlPackets, event.inclPackets);
 
-        }
+        logReceiveSummary();
+        AsyncLogger::instance().trace(TraceEvent::EventResponse, QByteArray(), false);
+        emit eventDataReady(eventParser.takeEvent());
+        emit responseCompleted(id, QByteArray());
     }
-    else if(msgId==0x08){
-        qDebug()<<"msg Id:"<<hex<<msgId;
-        if(buffer.startsWith(QByteArray::fromHex("53 54 47"))){
-            powerId=0x08;
-            ResponseData=buffer;
-            buffer.clear();
-            executeWriteToNotes("power on command Received bytes:"+ResponseData.toHex(' ').toUpper());
-        }
+    else if (state == EventStreamParser::State::Nack)
+    {
+        const QByteArray nack = QByteArray::fromHex("53 54 45 FF");
+        eventParser.reset();
+        executeWriteToNotes("Get Event Data cmd received bytes [NACK Condition]: " + nack.toHex(' ').toUpper());
 
+        logReceiveSummary();
+        AsyncLogger::instance().trace(TraceEvent::EventResponse, nack, false);
+        emit guiDisplay(nack);
+        emit responseCompleted(id, nack);
     }
-    else if(msgId==0x09){
-        qDebug()<<"msg Id:"<<hex<<msgId;
-        if(buffer.startsWith(QByteArray::fromHex("53 54 48"))){
-            powerId=0x09;
-            ResponseData=buffer;
-            buffer.clear();
-            executeWriteToNotes("power off command Received bytes:"+ResponseData.toHex(' ').toUpper());
-        }
-    }
-    else if(msgId==0x10){
-        qDebug()<<"msg Id:"<<hex<<msgId;
-        if(buffer.startsWith(QByteArray::fromHex("53 54 44"))){
-            powerId=0x10;
-            ResponseData=buffer;
-            buffer.clear();
-            executeWriteToNotes("log Time Response Received bytes:"+ResponseData.toHex(' ').toUpper());
-        }
-        else if(buffer.startsWith(QByteArray::fromHex("53 54 51"))){
-            powerId=0x10;
-            ResponseData=buffer;
-            buffer.clear();
-            executeWriteToNotes("Threshold Response Received bytes:"+ResponseData.toHex(' ').toUpper());
-        }
-        else if(buffer.startsWith(QByteArray::fromHex("53 54 49"))){
-            powerId=0x10;
-            ResponseData=buffer;
-            buffer.clear();
-            executeWriteToNotes("Set Time Response Received bytes:"+ResponseData.toHex(' ').toUpper());
-        }
-        else if(buffer.startsWith(QByteArray::fromHex("53 54 52"))){
-            powerId=0x10;
-            ResponseData=buffer;
-            buffer.clear();
-            executeWriteToNotes("ADXL Sampling frequency Response Received bytes:"+ResponseData.toHex(' ').toUpper());
-        }
-        else if(buffer.startsWith(QByteArray::fromHex("53 54 53"))){
-            powerId=0x10;
-            ResponseData=buffer;
-            buffer.clear();
-            executeWriteToNotes("Inclinometer frequency Response Received bytes:"+ResponseData.toHex(' ').toUpper());
-        }
-    }
-    else if(msgId==0x11){
-         qDebug()<<"msg Id:"<<hex<<msgId;
-         if(buffer.endsWith(QByteArray::fromHex("54 53 50")))
-         {
-             powerId=0x11;
-             ResponseData=buffer;
-             buffer.clear();
-             executeWriteToNotes("LivePlot stop Response Received bytes:"+ResponseData.toHex(' ').toUpper());
-             executeWriteToNotes("Total AdxlPackets:"+QString::number(adxlPackets));
-             executeWriteToNotes("Total InclPackets:"+QString::number(inclPackets));
-         }
-
+    else if (!eventProgressTimer.isValid() || eventProgressTimer.elapsed() >= EVENT_PROGRESS_INTERVAL_MS)
+    {
+        // Progress at a readable rate, readyRead fires every few hundred bytes
+        eventProgressTimer.start();
+        emit eventProgress(event.bytes, event.adxlPackets, event.inclPackets);
     }
-    else if(msgId==0x12)
-        {
-        qDebug()<<"1";
-            if (buffer.isEmpty())
-                return;
-            const QByteArray liveCheck=QByteArray::fromHex("53 54 56");
-            const QByteArray START_LOG_INIT = QByteArray::fromHex("54 53 41 43 4B");
-            const QByteArray START_LOG_END  = QByteArray::fromHex("54 53 50");
-
-            const QByteArray LIVE_HEADER = QByteArray::fromHex("AA BB");
-            const QByteArray LIVE_FOOTER = QByteArray::fromHex("FF FF");
-
-            const QByteArray ADXL_HEADER = QByteArray::fromHex("CC DD FF");
-            const QByteArray ADXL_FOOTER = QByteArray::fromHex("EE FF");
-
-            const QByteArray INCL_HEADER = QByteArray::fromHex("EE FF FF");
-            const QByteArray INCL_FOOTER = QByteArray::fromHex("CC DD");
-
-            // ---------------- START LOG INIT ----------------
-            if (buffer.startsWith(liveCheck))
-            {
-                ResponseData = liveCheck;
-                buffer.remove(0, liveCheck.size());
-
-                executeWriteToNotes("Start Log Initial cmd received");
-
-            }
-
-            else if (buffer.startsWith(START_LOG_INIT))
-            {
-                ResponseData = START_LOG_INIT;
-                buffer.remove(0, START_LOG_INIT.size());
-                powerId = 0x02;
-
-                executeWriteToNotes("Start Log Initial cmd received");
-
-            }
-
-            // ---------------- START LOG END ----------------
-            else if (buffer.startsWith(START_LOG_END))
-            {
-                ResponseData = START_LOG_END;
-                buffer.remove(0, START_LOG_END.size());
-                powerId = 0x02;
-
-                executeWriteToNotes("Start Log End cmd received");
-
-            }
-
-            // ---------------- LIVE FREQ PACKET ----------------
-            else if (buffer.startsWith(LIVE_HEADER))
-            {
-                int footerPos = buffer.indexOf(LIVE_FOOTER, LIVE_HEADER.size());
-                if (footerPos < 0) return;   // WAIT FOR FULL PACKET
-
-                int packetSize = footerPos + LIVE_FOOTER.size();
-                ResponseData = buffer.left(packetSize);
-                buffer.remove(0, packetSize);
-                powerId = 0x13;
-
-                executeWriteToNotes("Live Frequency Packet: size = "
-                                    + QString::number(ResponseData.size()));
-
-
-            }
-
-            // ---------------- ADXL PACKET ----------------
-            else if (buffer.startsWith(ADXL_HEADER))
-            {
-                int footerPos = buffer.indexOf(ADXL_FOOTER, ADXL_HEADER.size());
-                if (footerPos < 0) return;  // WAIT FOR FULL PACKET
-
-                int packetSize = footerPos + ADXL_FOOTER.size();
-                ResponseData = buffer.left(packetSize);
-                buffer.remove(0, packetSize);
-                adxlPackets++;
-                powerId = 0x13;
-
-                executeWriteToNotes("ADXL Packet: size = "
-                                    + QString::number(ResponseData.size()));
-
-
-            }
-
-            // ---------------- INCL PACKET ----------------
-            else if (buffer.startsWith(INCL_HEADER))
-            {
-                int footerPos = buffer.indexOf(INCL_FOOTER, INCL_HEADER.size());
-                if (footerPos < 0) return;  // WAIT FOR FULL PACKET
-
-                int packetSize = footerPos + INCL_FOOTER.size();
-                ResponseData = buffer.left(packetSize);
-                buffer.remove(0, packetSize);
-                inclPackets++;
-                powerId = 0x13;
-
-                executeWriteToNotes("Incl Packet: size = "
-                                    + QString::number(ResponseData.size()));
-
-
-            }
-            else{
-                executeWriteToNotes("The Packet:"
-                                    + buffer.toHex(' ').toUpper());
-                executeWriteToNotes("Live Data with Invalid Header");
-                buffer.clear();
-
-
-            }
-
+}
 
-        }
+bool serialPortHandler::dispatchLiveFrame(const ProtocolTable::Command &command, int &offset)
+{
+    if (offset >= buffer.size())
+        return false;
 
+    // Unconsumed bytes, viewed in place (no copy)
+    const QByteArray pending = QByteArray::fromRawData(buffer.constData() + offset, buffer.size() - offset);
 
-    else{
-        executeWriteToNotes("unknowm msg id");
+    const ProtocolTable::Response *response = ProtocolTable::match(command, pending);
+    if (!response)
+    {
+        AsyncLogger::instance().trace(TraceEvent::InvalidPacket, pending, false);
+        writeHexToNotes(LogLevel::Debug, "The Packet:", pending);
+        executeWriteToNotes("Live Data with Invalid Header");
+        offset = buffer.size();
+        return false;
     }
- executeWriteToNotes("powerId:"+QString::number(powerId));
-
 
-
-
-    switch(powerId)
+    // Acknowledge tokens are the signature itself, frames run up to their footer
+    int size = response->prefix.size();
+    if (response->match == ProtocolTable::Match::Frame)
     {
+        const int footerPos = pending.indexOf(response->suffix, response->prefix.size());
+        if (footerPos < 0)
+            return false;   // WAIT FOR FULL PACKET
+        size = footerPos + response->suffix.size();
+    }
+
+    // Data frames are only valid while the receivers run (direct connections, GUI thread), they copy what
+    // they keep. A completing acknowledge ends up in the scheduler's result, so it gets its own few bytes
+    const QByteArray frame = response->completes ? QByteArray(pending.constData(), size)
+                                                 : QByteArray::fromRawData(pending.constData(), size);
+    offset += size;
+    deliver(*response, frame);
+    return true;
+}
 
-    case 0x01:
-    {
-        emit guiDisplay(ResponseData);
-    }
-        break;
+void serialPortHandler::dispatchFramed(const ProtocolTable::Command &command)
+{
+    qDebug() << "msg Id:" << hex << command.msgId << buffer.size() << " :size";
 
-    case 0x02:
+    const ProtocolTable::Response *response = ProtocolTable::match(command, buffer);
+    if (!response)
     {
-        emit guiDisplay(ResponseData);
+        if (command.incompleteNote)
+            executeWriteToNotes(command.incompleteNote + QString::number(buffer.size()));
+        return;
     }
-        break;
 
-    case 0x03:
-    {
-        emit guiDisplay(ResponseData);
-    }
-        break;
+    const QByteArray data = buffer;
+    buffer.clear();
+    deliver(*response, data);
+}
 
-    case 0x04:
+void serialPortHandler::deliver(const ProtocolTable::Response &response, const QByteArray &data)
+{
+    // ---- Notes ----
+    switch (response.note)
     {
-        emit guiDisplay(ResponseData);
-    }
+    case ProtocolTable::Note::Text:
+        executeWriteToNotes(response.label);
         break;
-    case 0x05:
-    {
-        emit guiDisplay(ResponseData);
-    }
-      break;
-    case 0x06:
-    {
-        emit guiDisplay(ResponseData);
-    }
+    case ProtocolTable::Note::Hex:
+        executeWriteToNotes(response.label + data.toHex(' ').toUpper());
         break;
-     case 0x07:
-    {
-        emit guiDisplay(ResponseData);
-     }
+    case ProtocolTable::Note::DebugHex:
+        writeHexToNotes(LogLevel::Debug, response.label, data);
         break;
-      case 0x08:
-    {
-        emit guiDisplay(ResponseData);
-    }
+    case ProtocolTable::Note::Size:
+        executeWriteToNotes(QString(response.label) + " size = " + QString::number(data.size()));
+        writeHexToNotes(LogLevel::Trace, response.label, data);
         break;
-    case 0x09:
-    {
-        emit guiDisplay(ResponseData);
     }
-        break;
-     case 0x10:
+
+    if (response.counter == ProtocolTable::Counter::AdxlPackets)
+        adxlPackets++;
+    else if (response.counter == ProtocolTable::Counter::InclPackets)
+        inclPackets++;
+
+    if (response.liveTotals)
     {
-        emit guiDisplay(ResponseData);
+        executeWriteToNotes("Total AdxlPackets:" + QString::number(adxlPackets));
+        executeWriteToNotes("Total InclPackets:" + QString::number(inclPackets));
     }
-        break;
-     case 0x13:
-    {
-        emit liveData(ResponseData);
 
+    // ---- Trace ----
+    if (response.completes)
+    {
+        // Response complete, one counter line for all its chunks
+        // (bytes themselves are in the DataReceived records)
+        logReceiveSummary();
+        AsyncLogger::instance().trace(TraceEvent::Response, data, false);
     }
-        break;
-
-    default:
+    else if (response.delivery == ProtocolTable::Delivery::Live)
     {
-        qDebug() << "Unknown powerId: " <<hex << powerId << " with data: " << ResponseData.size();
+        AsyncLogger::instance().trace(response.trace, data, false);
     }
 
+    // ---- Delivery ----
+    switch (response.delivery)
+    {
+    case ProtocolTable::Delivery::Gui:
+        emit guiDisplay(data);
+        break;
+    case ProtocolTable::Delivery::Live:
+        emit liveData(data);
+        break;
+    case ProtocolTable::Delivery::None:
+        break;
     }
 
+    if (response.completes)
+        emit responseCompleted(id, data);
 }
 
-void serialPortHandler::recvMsgId(quint8 id)
+void serialPortHandler::recvMsgId(quint8 id, bool resetReceive)
 {
     qDebug() << "Received id:" <<hex<< id;
+    // Counters of a stream that never completed (live data, timeout) before the next command
+    logReceiveSummary();
+
     this->id = id;
-    buffer.clear();
+    if (resetReceive)
+    {
+        buffer.clear();
+        eventParser.reset();
+    }
+    eventProgressTimer.invalidate();
 
 }
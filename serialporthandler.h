@@ -7,6 +7,24 @@
 #include <QDebug>
 #include <QMutexLocker>
 #include <QMutex>
+#include <QElapsedTimer>
+
+#include "asynclogger.h"
+#include "eventstreamparser.h"
+#include "protocoltable.h"
+
+// What readData writes to debug_notes.txt about received bytes ([Logging] receiveLog)
+//   Off      nothing
+//   Summary  one counter line per response / download (chunks, bytes, chunk sizes, rate)
+//   Chunks   + one line per received chunk: length, offset in the response, optional sampled bytes
+//   Hex      + the full hex of each new chunk (never the accumulated buffer)
+enum class ReceiveLogMode
+{
+    Off,
+    Summary,
+    Chunks,
+    Hex
+};
 
 // Forward declaration of MainWindow
 class MainWindow;
@@ -17,7 +35,9 @@ public:
     explicit serialPortHandler(QObject *parent = nullptr);
      ~serialPortHandler();
 
-    void writeData(const QByteArray &data)
+    // False when the port isn't open (nothing written)
+    // resetReceive false keeps the receive buffer and parser, for a command written while a response is arriving
+    bool writeData(const QByteArray &data, bool resetReceive = true)
     {
         if(!serial->isOpen())
         {
@@ -26,18 +46,22 @@ public:
 
             qDebug() << "Serial object is not initialized";
             emit portOpening("Serial object is not initialized/port not selected");
-            return;
+            return false;
         }
-        else
+
+        if (resetReceive)
         {
-            if(serial->isOpen())
-            {
-                buffer.clear();
-                serial->write(data);
-            }
+            buffer.clear();
+            eventParser.reset();
         }
+        AsyncLogger::instance().trace(TraceEvent::CommandSent, data);
+        serial->write(data);
+        return true;
     }
 
+    // Keeps the raw Get Event Data response in the decoded event (for the event cache)
+    void setKeepEventResponse(bool keep) { eventParser.setKeepResponse(keep); }
+
     QStringList availablePorts();
 
     void setPORTNAME(const QString &portName);
@@ -48,6 +72,13 @@ public:
 
     QString hexBytesSerial(QByteArray &cmd);
 
+    // Hex dump of raw bytes into debug_notes.txt, skipped entirely below the logger level
+    void writeHexToNotes(LogLevel level, const QString &label, const QByteArray &bytes);
+
+    // sampleBytes: bytes from the start and end of each chunk shown in Chunks mode (0 = none)
+    void setReceiveLogMode(ReceiveLogMode mode, int sampleBytes = 8);
+    static ReceiveLogMode receiveLogModeFromString(const QString &name, ReceiveLogMode fallback = ReceiveLogMode::Summary);
+
 
 signals:
 
@@ -61,18 +92,54 @@ signals:
 
     void executeWriteToNotes(const QString &dataNotes);
 
+    // Get Event Data download, decoded while it arrives
+    void eventProgress(qint64 bytesReceived, int adxlPackets, int inclPackets);
+    void eventDataReady(const EventStreamParser::Event &event);
+
+    // The response to the current msgId is complete (after guiDisplay / eventDataReady), see CommandScheduler
+    void responseCompleted(quint8 msgId, const QByteArray &response);
+
 private slots:
 
     void readData();
 
 public slots:
 
-    void recvMsgId(quint8 id);
+    // resetReceive false : the new command's response continues the stream being received (Live Plot Stop),
+    // the bytes already buffered are parsed with the new msgId
+    void recvMsgId(quint8 id, bool resetReceive = true);
 
 private:
     QSerialPort *serial;
     QByteArray  buffer;
 
+    EventStreamParser eventParser;      // msgId 0x01, replaces accumulating the whole response in buffer
+    QElapsedTimer eventProgressTimer;
+
+    // Receive side counters of the current response / download
+    struct ReceiveStats
+    {
+        quint8 msgId = 0;
+        int chunks = 0;
+        qint64 bytes = 0;
+        int minChunk = 0;
+        int maxChunk = 0;
+        QElapsedTimer elapsed;      // since the first chunk
+    };
+
+    // ---- Response dispatch (see protocoltable.h) ----
+    void readEventChunk(const QByteArray &chunk);
+    bool dispatchLiveFrame(const ProtocolTable::Command &command, int &offset);   // false : nothing (more) to cut
+    void dispatchFramed(const ProtocolTable::Command &command);
+    void deliver(const ProtocolTable::Response &response, const QByteArray &data);
+
+    void logReceivedChunk(const QByteArray &chunk);
+    void logReceiveSummary();
+
+    ReceiveLogMode receiveLogMode = ReceiveLogMode::Summary;
+    int receiveSampleBytes = 8;
+    ReceiveStats receiveStats;
+
     quint8 id;
     int adxlPackets=0;
     int inclPackets=0;
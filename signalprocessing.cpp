@@ -0,0 +1,152 @@
+#include "signalprocessing.h"
+
+#include <QDebug>
+#include <QRunnable>
+#include <QThreadPool>
+#include <cmath>
+#include <vector>
+#include "kiss_fft.h"
+
+namespace
+{
+    class SpectrumTask : public QRunnable
+    {
+    public:
+        SpectrumTask(const QVector<double> &signal, double sampleRate, SignalProcessing::Spectrum &spectrum)
+            : mSignal(signal), mSampleRate(sampleRate), mSpectrum(spectrum) {}
+
+        void run() override
+        {
+            QVector<double> processed = mSignal;
+            SignalProcessing::applyHanning(processed);
+            SignalProcessing::performFFT(processed, mSpectrum.magnitude, mSpectrum.freqAxis, mSampleRate);
+        }
+
+    private:
+        const QVector<double> &mSignal;
+        double mSampleRate;
+        SignalProcessing::Spectrum &mSpectrum;
+    };
+}
+
+void SignalProcessing::removeDC(QVector<double> &x)
+{
+    if (x.isEmpty()) return;
+
+    double sum = 0;
+    for (double v : x) sum += v;
+    double mean = sum / x.size();
+
+    for (double &v : x) v -= mean;
+}
+
+void SignalProcessing::applyHanning(QVector<double> &signal)
+{
+    const int N = signal.size();
+
+    // --- Guard for invalid or trivial cases ---
+    if (N <= 1)
+    {
+        qWarning() << "applyHanning: signal too short (N =" << N << ")";
+        return;
+    }
+
+    // --- Precompute constant factor ---
+    const double coeff = 2.0 * M_PI / static_cast<double>(N - 1);
+
+    for (int n = 0; n < N; ++n)
+    {
+        const double w = 0.5 * (1.0 - std::cos(coeff * n));
+        signal[n] *= w;
+    }
+}
+
+void SignalProcessing::performFFT(const QVector<double> &input,
+                                  QVector<double> &magnitude,
+                                  QVector<double> &freqAxis,
+                                  double sampleRate)
+{
+    int N = input.size();
+
+    if (N <= 1)
+    {
+        qWarning() << "performFFT: invalid N =" << N;
+        return;
+    }
+
+    // --- Ensure power-of-two size ---
+    if ((N & (N - 1)) != 0)
+    {
+        int nextPow2 = pow(2, ceil(log2(N)));
+        qWarning() << "performFFT: non power-of-two size" << N << "-> padded to" << nextPow2;
+
+        QVector<double> padded = input;
+        padded.resize(nextPow2);
+        for (int i = N; i < nextPow2; ++i)
+            padded[i] = 0;
+
+        // recurse safely
+        performFFT(padded, magnitude, freqAxis, sampleRate);
+        return;
+    }
+
+    // --- Prepare input ---
+    std::vector<kiss_fft_cpx> timeData(N), freqData(N);
+    for (int i = 0; i < N; ++i)
+    {
+        timeData[i].r = input[i];
+        timeData[i].i = 0.0;
+    }
+
+    // --- Allocate FFT plan ---
+    kiss_fft_cfg cfg = kiss_fft_alloc(N, 0, nullptr, nullptr);
+    if (!cfg)
+    {
+        qCritical() << "performFFT: kiss_fft_alloc failed for N =" << N;
+        return;
+    }
+
+    // --- Execute safely ---
+    kiss_fft(cfg, timeData.data(), freqData.data());
+
+#ifdef kiss_fft_free
+    kiss_fft_free(cfg);
+#else
+    free(cfg);
+#endif
+
+    // --- Prepare output ---
+    int half = N / 2;
+    magnitude.resize(half + 1);
+    freqAxis.resize(half + 1);
+
+    const double windowGain = 0.5;
+
+    for (int k = 0; k <= half; ++k)
+    {
+        double re = freqData[k].r;
+        double im = freqData[k].i;
+        double mag = sqrt(re * re + im * im);
+
+        magnitude[k] = ((k == 0 || k == half) ? (mag / N) : ((2.0 * mag) / N)) / windowGain;
+        freqAxis[k] = (sampleRate * k) / N;
+    }
+}
+
+QVector<SignalProcessing::Spectrum> SignalProcessing::computeSpectra(const QVector<QVector<double>> &inputs,
+                                                                     double sampleRate)
+{
+    // Preallocated, every task fills its own entry
+    QVector<Spectrum> spectra(inputs.size());
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, inputs.size()));
+    for (int i = 0; i < inputs.size(); ++i)
+    {
+        if (inputs[i].size() > 1)
+            pool.start(new SpectrumTask(inputs[i], sampleRate, spectra[i]));
+    }
+    pool.waitForDone();
+
+    return spectra;
+}
@@ -0,0 +1,29 @@
+#ifndef SIGNALPROCESSING_H
+#define SIGNALPROCESSING_H
+
+#include <QVector>
+
+// FFT helpers shared by the event plots, live plots and the benchmark
+namespace SignalProcessing
+{
+    void removeDC(QVector<double> &x);
+
+    void applyHanning(QVector<double> &signal);
+
+    // Single-sided amplitude spectrum (Hanning gain compensated), input zero padded to power of two
+    void performFFT(const QVector<double> &input,
+                    QVector<double> &magnitude,
+                    QVector<double> &freqAxis,
+                    double sampleRate);
+
+    struct Spectrum
+    {
+        QVector<double> magnitude;
+        QVector<double> freqAxis;
+    };
+
+    // Hanning + performFFT of each signal, the signals are transformed concurrently (one task each)
+    QVector<Spectrum> computeSpectra(const QVector<QVector<double>> &inputs, double sampleRate);
+}
+
+#endif // SIGNALPROCESSING_H
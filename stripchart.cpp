@@ -0,0 +1,203 @@
+#include "stripchart.h"
+
+namespace
+{
+    const int FALLBACK_PIXEL_COLUMNS = 1920;    // axis rect not laid out yet
+}
+
+void StripChart::Extremes::add(double v)
+{
+    if (empty)
+    {
+        min = max = v;
+        minFirst = true;
+        empty = false;
+    }
+    else if (v < min)
+    {
+        min = v;
+        minFirst = false;       // the maximum came before this new minimum
+    }
+    else if (v > max)
+    {
+        max = v;
+        minFirst = true;
+    }
+}
+
+void StripChart::Extremes::add(const Extremes &other)
+{
+    if (other.empty)
+        return;
+    add(other.first());
+    add(other.second());
+}
+
+void StripChart::Ring::reset(int capacity, qint64 first)
+{
+    items.fill(Extremes(), qMax(1, capacity));
+    head = 0;
+    filled = 0;
+    firstNumber = first;
+}
+
+void StripChart::Ring::push(const Extremes &e)
+{
+    if (filled == items.size())
+    {
+        // Full: the oldest one scrolls out
+        items[head] = e;
+        head = (head + 1) % items.size();
+        firstNumber++;
+    }
+    else
+    {
+        items[(head + filled) % items.size()] = e;
+        filled++;
+    }
+}
+
+StripChart::StripChart()
+{
+}
+
+void StripChart::configure(int windowSamples, int historyBuckets)
+{
+    mWindowSamples = qMax(1, windowSamples);
+
+    historyBuckets = qMax(1, historyBuckets);
+    mBucketSize = (mWindowSamples + historyBuckets - 1) / historyBuckets;
+    mPixelColumns = 0;
+
+    reset();
+}
+
+void StripChart::reset()
+{
+    mBuckets.reset((mWindowSamples + mBucketSize - 1) / mBucketSize + 1, 0);
+    mCurrentBucket = Extremes();
+    mCurrentCount = 0;
+    mSamples = 0;
+    setPixelColumns(mPixelColumns > 0 ? mPixelColumns : FALLBACK_PIXEL_COLUMNS);
+    mDirty = true;
+}
+
+void StripChart::setPixelColumns(int columns)
+{
+    const int windowBuckets = (mWindowSamples + mBucketSize - 1) / mBucketSize;
+    const int columnBuckets = qMax(1, (windowBuckets + columns - 1) / qMax(1, columns));
+    if (columns == mPixelColumns && columnBuckets == mColumnBuckets && !mColumns.items.isEmpty())
+        return;
+
+    mPixelColumns = columns;
+    mColumnBuckets = columnBuckets;
+
+    // ---- Columns rebuilt from the kept buckets (plot resized or history cleared) ----
+    const qint64 firstColumn = mBuckets.firstNumber / mColumnBuckets;
+    mColumns.reset((windowBuckets + mColumnBuckets - 1) / mColumnBuckets + 2, firstColumn);
+    mCurrentColumn = Extremes();
+    for (qint64 b = mBuckets.firstNumber; b < mBuckets.endNumber(); ++b)
+        foldIntoColumn(b, mBuckets.at(b));
+}
+
+void StripChart::append(const QVector<double> &values)
+{
+    if (!isConfigured() || values.isEmpty())
+        return;
+
+    for (double v : values)
+    {
+        mCurrentBucket.add(v);
+        mSamples++;
+        if (++mCurrentCount == mBucketSize)
+            closeBucket();
+    }
+    mDirty = true;
+}
+
+void StripChart::closeBucket()
+{
+    const qint64 number = mBuckets.endNumber();
+    mBuckets.push(mCurrentBucket);
+    foldIntoColumn(number, mCurrentBucket);
+
+    mCurrentBucket = Extremes();
+    mCurrentCount = 0;
+}
+
+void StripChart::foldIntoColumn(qint64 bucketNumber, const Extremes &bucket)
+{
+    mCurrentColumn.add(bucket);
+
+    // Last bucket of its column: the column is complete
+    if ((bucketNumber + 1) % mColumnBuckets == 0)
+    {
+        mColumns.push(mCurrentColumn);
+        mCurrentColumn = Extremes();
+    }
+}
+
+QCPRange StripChart::render(QCPGraph *graph, bool &foundRange)
+{
+    foundRange = false;
+    QCPRange valueRange;
+    if (!graph || !isConfigured())
+        return valueRange;
+
+    const int width = graph->keyAxis()->axisRect()->width();
+    setPixelColumns(width > 0 ? width : FALLBACK_PIXEL_COLUMNS);
+
+    // Partial column: completed buckets of the newest column plus the bucket being filled
+    Extremes partial = mCurrentColumn;
+    partial.add(mCurrentBucket);
+
+    const qint64 columnSize = qint64(mColumnBuckets) * mBucketSize;     // samples per column
+    const qint64 lower = qMax<qint64>(0, mSamples - mWindowSamples);
+    const qint64 firstColumn = qMax(mColumns.firstNumber, lower / columnSize);
+    const qint64 endColumn = mColumns.endNumber();
+    const int pointsPerColumn = (columnSize == 1) ? 1 : 2;
+    const int points = int(qMax<qint64>(0, endColumn - firstColumn)) * pointsPerColumn
+            + (partial.empty ? 0 : pointsPerColumn);
+
+    // ---- Window written in place into the graph container ----
+    QSharedPointer<QCPGraphDataContainer> data = graph->data();
+    data->reserveStreaming(2 * pointsPerColumn * (mColumns.items.size() + 1));
+    data->removeFront(data->size());
+    QCPGraphDataContainer::iterator it = data->appendSorted(points);
+
+    auto emitColumn = [&](qint64 columnNumber, const Extremes &column)
+    {
+        const double key = double(columnNumber * columnSize);
+        it->key = key;
+        it->value = column.first();
+        ++it;
+        if (pointsPerColumn == 2)
+        {
+            it->key = qMin(key + (columnSize - 1) / 2.0, double(mSamples - 1));     // partial column ends at the newest sample
+            it->value = column.second();
+            ++it;
+        }
+
+        if (!foundRange)
+        {
+            valueRange = QCPRange(column.min, column.max);
+            foundRange = true;
+        }
+        else
+        {
+            valueRange.expand(column.min);
+            valueRange.expand(column.max);
+        }
+    };
+
+    for (qint64 c = firstColumn; c < endColumn; ++c)
+        emitColumn(c, mColumns.at(c));
+    if (!partial.empty)
+        emitColumn(endColumn, partial);
+
+    // Fixed width window: fills from the left, then scrolls with the newest sample at the right edge
+    graph->keyAxis()->setRange(double(lower), double(lower + mWindowSamples));
+
+    mDirty = false;
+    return valueRange;
+}
@@ -0,0 +1,86 @@
+#ifndef STRIPCHART_H
+#define STRIPCHART_H
+
+#include <QVector>
+
+#include "qcustomplot.h"
+
+// Scrolling history of one live channel (strip chart), fixed memory whatever the capture length
+// Samples are keyed by their running index since the capture started (continuous across packets).
+// Two min/max levels are maintained incrementally as samples arrive, both aligned to that index so
+// nothing shimmers while the window scrolls:
+//   buckets  bucketSize samples each, at most historyBuckets over the window (survive plot resizes)
+//   columns  one per pixel column of the plot, merged from the buckets
+// A redraw hands the graph two points per pixel column, so replot cost follows the plot width and not
+// the sample rate
+class StripChart
+{
+public:
+    static const int DEFAULT_HISTORY_BUCKETS = 4096;
+
+    StripChart();
+
+    // Window length in samples, clears the history
+    void configure(int windowSamples, int historyBuckets = DEFAULT_HISTORY_BUCKETS);
+    void reset();
+
+    bool isConfigured() const { return mWindowSamples > 0; }
+    int windowSamples() const { return mWindowSamples; }
+    qint64 sampleCount() const { return mSamples; }
+    bool isDirty() const { return mDirty; }
+
+    void append(const QVector<double> &values);
+
+    // Writes the window into the graph (in place, no allocation once warmed up) and scrolls its key axis,
+    // returns the value range drawn so the caller can fit the value axis over several graphs
+    QCPRange render(QCPGraph *graph, bool &foundRange);
+
+private:
+    // Running min/max of a span, remembers which extreme came first so the line keeps the signal's order
+    struct Extremes
+    {
+        double min = 0, max = 0;
+        bool minFirst = true;
+        bool empty = true;
+
+        void add(double v);
+        void add(const Extremes &other);
+        double first() const { return minFirst ? min : max; }
+        double second() const { return minFirst ? max : min; }
+    };
+
+    // Fixed capacity ring of completed spans, numbered by their absolute position
+    struct Ring
+    {
+        QVector<Extremes> items;
+        int head = 0;
+        int filled = 0;
+        qint64 firstNumber = 0;     // number of items[head]
+
+        void reset(int capacity, qint64 first);
+        void push(const Extremes &e);
+        qint64 endNumber() const { return firstNumber + filled; }
+        const Extremes &at(qint64 number) const { return items[(head + int(number - firstNumber)) % items.size()]; }
+    };
+
+    void setPixelColumns(int columns);
+    void closeBucket();
+    void foldIntoColumn(qint64 bucketNumber, const Extremes &bucket);
+
+    int mWindowSamples = 0;
+    int mBucketSize = 1;            // samples per bucket
+    int mColumnBuckets = 1;         // buckets per pixel column
+    int mPixelColumns = 0;
+
+    Ring mBuckets;
+    Extremes mCurrentBucket;
+    int mCurrentCount = 0;
+
+    Ring mColumns;
+    Extremes mCurrentColumn;
+
+    qint64 mSamples = 0;
+    bool mDirty = false;
+};
+
+#endif // STRIPCHART_H
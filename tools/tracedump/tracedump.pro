@@ -0,0 +1,24 @@
+########################################
+# tracedump : renders debug_trace.bin as text
+#   qmake tracedump.pro && make
+#   ./tracedump debug_trace.bin [--payload] [--type ADXL_PACKET]
+########################################
+
+QT       += core
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = tracedump
+
+INCLUDEPATH += $$PWD/../..
+
+HEADERS += \
+    ../../tracelog.h
+
+SOURCES += \
+    tracedumpmain.cpp \
+    ../../tracelog.cpp
+
+DEFINES += QT_DEPRECATED_WARNINGS
@@ -0,0 +1,92 @@
+// Offline decoder for the binary packet trace written by the Envirologger (debug_trace.bin)
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+
+#include "tracelog.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("tracedump");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Render an Envirologger binary trace as text");
+    parser.addHelpOption();
+    parser.addPositionalArgument("trace", "Trace file (debug_trace.bin).");
+    parser.addOption({ "payload", "Print payload bytes as hex." });
+    parser.addOption({ "max-bytes", "Limit printed payload bytes per record (default all).", "n", "0" });
+    parser.addOption({ "type", "Only print records of this type (e.g. ADXL_PACKET).", "name" });
+    parser.addOption({ "summary", "Print per type record counts and byte totals only." });
+    parser.process(app);
+
+    QTextStream out(stdout);
+
+    if (parser.positionalArguments().isEmpty())
+    {
+        parser.showHelp(1);
+    }
+
+    QFile file(parser.positionalArguments().first());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        QTextStream(stderr) << "Unable to open " << file.fileName() << "\n";
+        return 1;
+    }
+
+    qint64 startEpochMs = 0;
+    QString error;
+    if (!TraceLog::readFileHeader(file, startEpochMs, error))
+    {
+        QTextStream(stderr) << file.fileName() << ": " << error << "\n";
+        return 1;
+    }
+
+    const bool showPayload = parser.isSet("payload");
+    const int maxBytes = parser.value("max-bytes").toInt();
+    const QString typeFilter = parser.value("type").toUpper();
+    const bool summaryOnly = parser.isSet("summary");
+
+    QMap<QString, QPair<qint64, qint64>> summary;   // type -> (records, bytes)
+
+    out << "# Trace started " << QDateTime::fromMSecsSinceEpoch(startEpochMs).toString("yyyy-MM-dd HH:mm:ss.zzz") << "\n";
+
+    TraceLog::TraceRecord record;
+    qint64 count = 0;
+    while (TraceLog::readRecord(file, record))
+    {
+        const QString name = TraceLog::eventName(record.type);
+        if (!typeFilter.isEmpty() && name != typeFilter)
+            continue;
+
+        count++;
+        summary[name].first++;
+        summary[name].second += record.length;
+
+        if (summaryOnly)
+            continue;
+
+        const qint64 wallMs = startEpochMs + static_cast<qint64>(record.monotonicNs / 1000000);
+        out << "[" << QDateTime::fromMSecsSinceEpoch(wallMs).toString("HH:mm:ss.zzz") << "] "
+            << QString("+%1 s ").arg(record.monotonicNs / 1e9, 0, 'f', 6)
+            << name << " len=" << record.length;
+
+        if (showPayload && (record.flags & TraceLog::TRACE_FLAG_PAYLOAD))
+        {
+            QByteArray bytes = (maxBytes > 0) ? record.payload.left(maxBytes) : record.payload;
+            out << " : " << bytes.toHex(' ').toUpper();
+            if (bytes.size() < record.payload.size())
+                out << " ...";
+        }
+        out << "\n";
+    }
+
+    out << "# " << count << " records\n";
+    for (auto it = summary.constBegin(); it != summary.constEnd(); ++it)
+        out << "#   " << it.key() << " : " << it.value().first << " records, " << it.value().second << " bytes\n";
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "tracelog.h"
+
+#include <QtEndian>
+#include <cstring>
+
+QByteArray TraceLog::fileHeader(qint64 startEpochMs)
+{
+    QByteArray header(FILE_HEADER_SIZE, char(0));
+    uchar *p = reinterpret_cast<uchar *>(header.data());
+
+    memcpy(p, MAGIC, 4);
+    qToLittleEndian<quint16>(TRACE_VERSION, p + 4);
+    qToLittleEndian<quint16>(0, p + 6);
+    qToLittleEndian<qint64>(startEpochMs, p + 8);
+    return header;
+}
+
+bool TraceLog::readFileHeader(QIODevice &device, qint64 &startEpochMs, QString &error)
+{
+    QByteArray header = device.read(FILE_HEADER_SIZE);
+    if (header.size() != FILE_HEADER_SIZE || memcmp(header.constData(), MAGIC, 4) != 0)
+    {
+        error = "Not a trace file (bad magic)";
+        return false;
+    }
+
+    const uchar *p = reinterpret_cast<const uchar *>(header.constData());
+    quint16 version = qFromLittleEndian<quint16>(p + 4);
+    if (version != TRACE_VERSION)
+    {
+        error = QString("Unsupported trace version %1").arg(version);
+        return false;
+    }
+
+    startEpochMs = qFromLittleEndian<qint64>(p + 8);
+    return true;
+}
+
+void TraceLog::appendRecord(QByteArray &out, TraceEvent type, quint64 monotonicNs,
+                            const QByteArray &payload, bool withPayload)
+{
+    uchar header[RECORD_HEADER_SIZE];
+    qToLittleEndian<quint16>(static_cast<quint16>(type), header);
+    qToLittleEndian<quint16>(withPayload ? TRACE_FLAG_PAYLOAD : 0, header + 2);
+    qToLittleEndian<quint32>(static_cast<quint32>(payload.size()), header + 4);
+    qToLittleEndian<quint64>(monotonicNs, header + 8);
+
+    out.append(reinterpret_cast<const char *>(header), RECORD_HEADER_SIZE);
+    if (withPayload)
+        out.append(payload);
+}
+
+bool TraceLog::readRecord(QIODevice &device, TraceRecord &record)
+{
+    QByteArray header = device.read(RECORD_HEADER_SIZE);
+    if (header.size() != RECORD_HEADER_SIZE)
+        return false;
+
+    const uchar *p = reinterpret_cast<const uchar *>(header.constData());
+    record.type = static_cast<TraceEvent>(qFromLittleEndian<quint16>(p));
+    record.flags = qFromLittleEndian<quint16>(p + 2);
+    record.length = qFromLittleEndian<quint32>(p + 4);
+    record.monotonicNs = qFromLittleEndian<quint64>(p + 8);
+    record.payload.clear();
+
+    if (record.flags & TRACE_FLAG_PAYLOAD)
+    {
+        record.payload = device.read(record.length);
+        if (record.payload.size() != static_cast<int>(record.length))
+            return false;   // truncated record at the end of the file
+    }
+    return true;
+}
+
+QString TraceLog::eventName(TraceEvent type)
+{
+    switch (type)
+    {
+    case TraceEvent::DataReceived:   return "DATA_RECEIVED";
+    case TraceEvent::CommandSent:    return "COMMAND_SENT";
+    case TraceEvent::EventResponse:  return "EVENT_RESPONSE";
+    case TraceEvent::AdxlPacket:     return "ADXL_PACKET";
+    case TraceEvent::InclPacket:     return "INCL_PACKET";
+    case TraceEvent::LiveFreqPacket: return "LIVE_FREQ_PACKET";
+    case TraceEvent::InvalidPacket:  return "INVALID_PACKET";
+    case TraceEvent::Response:       return "RESPONSE";
+    }
+    return QString("UNKNOWN_%1").arg(static_cast<quint16>(type));
+}
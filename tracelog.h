@@ -0,0 +1,64 @@
+#ifndef TRACELOG_H
+#define TRACELOG_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+
+// Binary packet trace (debug_trace.bin), all integers little-endian
+//
+//   File header (16 bytes)
+//     char[4]  magic            "ELTR"
+//     quint16  version          TRACE_VERSION
+//     quint16  reserved
+//     qint64   startEpochMs     wall clock when monotonic time was 0
+//
+//   Record (16 byte header + optional payload)
+//     quint16  type             TraceEvent
+//     quint16  flags            TRACE_FLAG_*
+//     quint32  length           length of the original payload
+//     quint64  monotonicNs      time since the trace file was opened
+//     char[]   payload          present only with TRACE_FLAG_PAYLOAD
+//
+// Decode offline with tools/tracedump
+enum class TraceEvent : quint16
+{
+    DataReceived    = 1,    // raw serial chunk from readyRead
+    CommandSent     = 2,    // command bytes written to the device
+    EventResponse   = 3,    // Get Event Data response complete (streamed: no bytes, they are in DataReceived)
+    AdxlPacket      = 4,    // live ADXL packet
+    InclPacket      = 5,    // live inclinometer packet
+    LiveFreqPacket  = 6,    // live frequency packet
+    InvalidPacket   = 7,    // bytes dropped because of an invalid header
+    Response        = 8     // any other command response
+};
+
+namespace TraceLog
+{
+    const char     MAGIC[4]           = { 'E', 'L', 'T', 'R' };
+    const quint16  TRACE_VERSION      = 1;
+    const int      FILE_HEADER_SIZE   = 16;
+    const int      RECORD_HEADER_SIZE = 16;
+
+    const quint16  TRACE_FLAG_PAYLOAD = 0x0001;
+
+    struct TraceRecord
+    {
+        TraceEvent type = TraceEvent::DataReceived;
+        quint16 flags = 0;
+        quint32 length = 0;
+        quint64 monotonicNs = 0;
+        QByteArray payload;
+    };
+
+    QByteArray fileHeader(qint64 startEpochMs);
+    bool readFileHeader(QIODevice &device, qint64 &startEpochMs, QString &error);
+
+    void appendRecord(QByteArray &out, TraceEvent type, quint64 monotonicNs,
+                      const QByteArray &payload, bool withPayload);
+    bool readRecord(QIODevice &device, TraceRecord &record);
+
+    QString eventName(TraceEvent type);
+}
+
+#endif // TRACELOG_H